@@ -7,6 +7,7 @@
  */
 
 #include "analog.h"
+#include "hardware/dma.h"
 #include <stdio.h>
 
 /** @brief Store for last axis value - X*/
@@ -14,6 +15,67 @@ int analog_x = 0;
 /** @brief Store for last axis value - Y */
 int analog_y = 0;
 
+/** @brief Conversions written by the DMA; aligned to its size for the DMA ring. */
+static volatile uint16_t samples[ANALOG_RING_SAMPLES] __attribute__((aligned(1 << ANALOG_RING_BITS)));
+/** @brief DMA channel copying the ADC FIFO into the ring. */
+static int sampleDma = -1;
+
+/**
+ * @brief Starts the conversions from input 0 with the DMA writing from the start of the ring.
+ *
+ * Input 0 always lands on even positions of the ring and input 1 on odd ones.
+ */
+static void startSampling()
+{
+    adc_select_input(0);
+    adc_fifo_drain();
+
+    dma_channel_config config = dma_channel_get_default_config(sampleDma);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, true);
+    channel_config_set_ring(&config, true, ANALOG_RING_BITS); // Volta ao início do anel
+    channel_config_set_dreq(&config, DREQ_ADC);
+    dma_channel_configure(sampleDma, &config, samples, &adc_hw->fifo, 0xffffffff, true);
+
+    adc_run(true);
+}
+
+/**
+ * @brief Restarts the sampling before the DMA transfer count runs out (after weeks).
+ */
+static void keepSampling()
+{
+    if (dma_channel_hw_addr(sampleDma)->transfer_count > ANALOG_RING_SAMPLES)
+    {
+        return;
+    }
+
+    adc_run(false);
+    dma_channel_abort(sampleDma);
+    while (!(adc_hw->cs & ADC_CS_READY_BITS))
+    {
+        tight_loop_contents(); // Espera a conversão em andamento
+    }
+    startSampling();
+}
+
+/**
+ * @brief Averages the samples of one input in the ring.
+ *
+ * @param input ADC input, 0 or 1.
+ * @return Average reading, 0 to 4095.
+ */
+static uint32_t averageInput(int input)
+{
+    uint32_t sum = 0;
+    for (int i = input; i < ANALOG_RING_SAMPLES; i += 2)
+    {
+        sum += samples[i];
+    }
+    return sum / (ANALOG_RING_SAMPLES / 2);
+}
+
 /**
  * @brief Initializes the analog inputs and button.
  *
@@ -21,6 +83,8 @@ int analog_y = 0;
  * the GPIO (General-Purpose Input/Output) pins for the analog inputs and button.
  * It initializes the ADC, sets up the GPIO pins for the analog X and Y inputs,
  * and configures the button pin as an input with a pull-up resistor.
+ * The ADC then converts both inputs in round-robin, paced by its clock
+ * divider, and the DMA keeps the ring filled without the CPU.
  */
 void initAnalog()
 {
@@ -30,12 +94,24 @@ void initAnalog()
     gpio_init(ANALOG_BTN);
     gpio_set_dir(ANALOG_BTN, GPIO_IN);
     gpio_pull_up(ANALOG_BTN);
+
+    // Até a primeira volta do anel, a média vê o joystick no centro
+    for (int i = 0; i < ANALOG_RING_SAMPLES; i++)
+    {
+        samples[i] = 2048;
+    }
+
+    adc_set_round_robin((1 << 0) | (1 << 1));
+    adc_fifo_setup(true, true, 1, false, false); // Cada conversão gera um pedido de DMA
+    adc_set_clkdiv(48000000.0f / ANALOG_SAMPLE_RATE_HZ - 1);
+    sampleDma = dma_claim_unused_channel(true);
+    startSampling();
 }
 
 /**
  * @brief Reads analog Y axis value.
  *
- * This function select the gpio that represents the axis Y, reads the adc value,
+ * This function averages the samples of the axis Y in the ring (input 0),
  * map the value from a range to another and after it apply a threshold to reduce sensibility
  *
  * @return The calibrated analog value for the Y axis, with deadzone applied.
@@ -43,8 +119,7 @@ void initAnalog()
  */
 int32_t readAnalogY()
 {
-    adc_select_input(0);
-    uint32_t adc_value = adc_read();
+    uint32_t adc_value = averageInput(0);
     int32_t mapped_value = mapValue(adc_value, 0, 4095, -ANALOG_MAX_VALUE, ANALOG_MAX_VALUE);
     int32_t inverted_value = -mapped_value;
     return applyThreshold(inverted_value);
@@ -53,7 +128,7 @@ int32_t readAnalogY()
 /**
  * @brief Reads analog X axis value.
  *
- * This function select the gpio that represents the axis X, reads the adc value,
+ * This function averages the samples of the axis X in the ring (input 1),
  * map the value from a range to another and after it apply a threshold to reduce sensibility
  *
  * @return The calibrated analog value for the X axis, with deadzone applied.
@@ -61,8 +136,7 @@ int32_t readAnalogY()
  */
 int32_t readAnalogX()
 {
-    adc_select_input(1);
-    uint32_t adc_value = adc_read();
+    uint32_t adc_value = averageInput(1);
     int32_t mapped_value = mapValue(adc_value, 0, 4095, -ANALOG_MAX_VALUE, ANALOG_MAX_VALUE);
     return applyThreshold(mapped_value);
 }
@@ -91,10 +165,12 @@ int32_t applyThreshold(int32_t value)
 /**
  * @brief Updates analog axis values.
  *
- * Reads current value to both axis in the system.
+ * Reads current value to both axis in the system. Does not wait for the ADC,
+ * so it may run from an interrupt.
  */
 void updateAxis()
 {
+    keepSampling();
     analog_x = readAnalogX();
     analog_y = readAnalogY();
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 /**
  * @file analog.h
  * @brief Header file for the analog input module.
+ *
+ * The ADC runs free in round-robin over both axes at ANALOG_SAMPLE_RATE_HZ,
+ * and a DMA channel copies every conversion into a ring in RAM. Reading an
+ * axis averages its samples in the ring, so reads never wait for the ADC.
  */
 
 #ifndef ANALOG_H
@@ -22,12 +26,23 @@
 /** @brief Deadzone threshold for analog inputs. */
 #define DEADZONE 2
 
+/** @brief Conversions per second, both axes together. */
+#ifndef ANALOG_SAMPLE_RATE_HZ
+#define ANALOG_SAMPLE_RATE_HZ 2000
+#endif
+
+/** @brief log2 of the sample ring size in bytes; the ring holds half as many 16-bit samples. */
+#define ANALOG_RING_BITS 7
+
+/** @brief Samples in the ring, alternating Y (even) and X (odd). */
+#define ANALOG_RING_SAMPLES ((1 << ANALOG_RING_BITS) / 2)
+
 /** @brief Last read value for axis X. */
 extern int analog_x;
 /** @brief Last read value for axis Y. */
 extern int analog_y;
 
-/** @brief Initializes the analog inputs and button. */
+/** @brief Initializes the analog inputs and button and starts the sampling. */
 void initAnalog();
 
 /** @brief Reads analog Y axis value. */
@@ -0,0 +1,162 @@
+/**
+ * @file connect_cache.c
+ * @brief Implementation for the cache of networks joined before.
+ */
+
+#include "connect_cache.h"
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/** @brief Offset of the cache in the flash: the last sector. */
+#define CONNECT_CACHE_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+/** @brief Marks a sector written by this firmware ("WCC1"). */
+#define CONNECT_CACHE_MAGIC 0x31434357u
+
+/** @brief Sector contents. */
+typedef struct {
+    uint32_t magic;
+    uint32_t joinCount;
+    connect_cache_entry_t entries[CONNECT_CACHE_SIZE];
+    uint32_t checksum;
+} connect_cache_image_t;
+
+_Static_assert(sizeof(connect_cache_image_t) <= FLASH_SECTOR_SIZE, "CONNECT_CACHE_SIZE too large for one flash sector");
+
+/** @brief Size written to the flash, a multiple of the page size. */
+#define CONNECT_CACHE_PROGRAM_SIZE ((sizeof(connect_cache_image_t) + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE * FLASH_PAGE_SIZE)
+
+/** @brief Cache in RAM; padded to whole pages so it can be programmed as is. */
+static union {
+    connect_cache_image_t image;
+    uint8_t bytes[CONNECT_CACHE_PROGRAM_SIZE];
+} cache;
+
+/**
+ * @brief FNV-1a hash of the image, without the checksum field.
+ */
+static uint32_t getChecksum(const connect_cache_image_t *image)
+{
+    const uint8_t *bytes = (const uint8_t *)image;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(connect_cache_image_t, checksum); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Returns the image stored in the flash, read through the XIP window.
+ */
+static const connect_cache_image_t *getFlashImage()
+{
+    return (const connect_cache_image_t *)(XIP_BASE + CONNECT_CACHE_OFFSET);
+}
+
+void loadConnectCache()
+{
+    const connect_cache_image_t *stored = getFlashImage();
+
+    memset(&cache, 0, sizeof(cache));
+    if (stored->magic == CONNECT_CACHE_MAGIC && stored->checksum == getChecksum(stored))
+    {
+        cache.image = *stored;
+    }
+    else
+    {
+        cache.image.magic = CONNECT_CACHE_MAGIC; // Setor apagado ou de outra versão
+    }
+}
+
+const connect_cache_entry_t *findCachedNetwork(const uint8_t *bssid)
+{
+    for (int i = 0; i < CONNECT_CACHE_SIZE; i++)
+    {
+        const connect_cache_entry_t *entry = &cache.image.entries[i];
+        if (entry->channel != 0 && memcmp(entry->bssid, bssid, sizeof(entry->bssid)) == 0)
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+const connect_cache_entry_t *getLatestCachedNetwork()
+{
+    const connect_cache_entry_t *latest = NULL;
+    for (int i = 0; i < CONNECT_CACHE_SIZE; i++)
+    {
+        const connect_cache_entry_t *entry = &cache.image.entries[i];
+        if (entry->channel != 0 && (latest == NULL || entry->lastJoin > latest->lastJoin))
+        {
+            latest = entry;
+        }
+    }
+    return latest;
+}
+
+/**
+ * @brief Erases the cache sector and programs the image; runs with interrupts off.
+ */
+static void writeCacheSector(void *param)
+{
+    flash_range_erase(CONNECT_CACHE_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(CONNECT_CACHE_OFFSET, cache.bytes, sizeof(cache.bytes));
+}
+
+/**
+ * @brief Chooses the entry for a network: its own, else an empty one, else the least recently joined.
+ */
+static connect_cache_entry_t *chooseSlot(const uint8_t *bssid)
+{
+    connect_cache_entry_t *slot = (connect_cache_entry_t *)findCachedNetwork(bssid);
+    if (slot != NULL)
+    {
+        return slot;
+    }
+
+    slot = &cache.image.entries[0];
+    for (int i = 0; i < CONNECT_CACHE_SIZE; i++)
+    {
+        connect_cache_entry_t *entry = &cache.image.entries[i];
+        if (entry->channel == 0)
+        {
+            return entry;
+        }
+        if (entry->lastJoin < slot->lastJoin)
+        {
+            slot = entry;
+        }
+    }
+    return slot;
+}
+
+bool rememberConnection(const connect_cache_entry_t *entry)
+{
+    connect_cache_entry_t *slot = chooseSlot(entry->bssid);
+
+    // Reconectar à rede mais recente não muda nada: a flash só é gravada se preciso
+    bool latest = slot == getLatestCachedNetwork();
+    connect_cache_entry_t updated = *entry;
+    updated.lastJoin = latest ? slot->lastJoin : ++cache.image.joinCount;
+    if (memcmp(slot, &updated, sizeof(updated)) == 0)
+    {
+        return true;
+    }
+
+    *slot = updated;
+    cache.image.checksum = getChecksum(&cache.image);
+
+    int err = flash_safe_execute(writeCacheSector, NULL, 100);
+    if (err != 0)
+    {
+        printf("Falha ao gravar o cache de conexões: %d\n", err);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file connect_cache.h
+ * @brief Header file for the cache of networks joined before.
+ *
+ * Keeps the association parameters of the last networks joined (BSSID,
+ * channel, auth type and passphrase) in the last sector of the flash, so a
+ * reconnection joins the known AP on its channel directly instead of
+ * searching every channel for the SSID.
+ */
+
+#ifndef CONNECT_CACHE_H
+#define CONNECT_CACHE_H
+
+#include "pico/stdlib.h"
+
+/** @brief Number of networks kept; the least recently joined is replaced. */
+#ifndef CONNECT_CACHE_SIZE
+#define CONNECT_CACHE_SIZE 4
+#endif
+
+/** @brief Association parameters of a network joined before. */
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;      // 0 se a entrada estiver vazia
+    uint8_t _reserved;
+    uint32_t auth;        // Tipo de autenticação do cyw43 (CYW43_AUTH_*)
+    uint32_t lastJoin;    // Ordem da última conexão, para substituir a mais antiga
+    char ssid[33];
+    char password[65];
+} connect_cache_entry_t;
+
+/**
+ * @brief Loads the cache from the flash; an erased or corrupted sector gives an empty cache.
+ *
+ * Call before the other core starts.
+ */
+void loadConnectCache();
+
+/**
+ * @brief Looks up a network by BSSID.
+ *
+ * @return The entry, or NULL if the network was never joined.
+ */
+const connect_cache_entry_t *findCachedNetwork(const uint8_t *bssid);
+
+/**
+ * @brief Returns the network joined most recently, or NULL if the cache is empty.
+ */
+const connect_cache_entry_t *getLatestCachedNetwork();
+
+/**
+ * @brief Stores the parameters of a successful connection and writes the cache to the flash.
+ *
+ * The flash is only written when the cache changed. Runs with the other
+ * core locked out, which must have called flash_safe_execute_core_init().
+ *
+ * @param entry Parameters of the network joined, zero-filled beyond the strings.
+ * @return true if the cache is saved.
+ */
+bool rememberConnection(const connect_cache_entry_t *entry);
+
+#endif // CONNECT_CACHE_H
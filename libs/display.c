@@ -11,6 +11,9 @@
 #include "display.h"
 ssd1306_t display;
 
+/** @brief DMA transport used to flush frames without blocking the main loop. */
+static ssd1306_dma_t displayDma;
+
 /**
  * @brief Initializes the I2C interface with a specified frequency and configures the GPIO pins.
  *
@@ -35,6 +38,8 @@ void initI2C()
  *
  * This function initializes the SSD1306 display with the specified parameters.
  * It checks if the initialization is successful and prints a message accordingly.
+ * Once initialized, frames are flushed through a DMA channel; if none is available
+ * the display keeps using blocking I2C writes.
  *
  * @note The function uses the global variables `display`, `SCREEN_WIDTH`, `SCREEN_HEIGHT`,
  * `SCREEN_ADDRESS`, and `i2c1` for initialization.
@@ -50,6 +55,16 @@ void initDisplay()
     else
     {
         printf("Display SSD1306 inicializado\n");
+
+        ssd1306_bus_t bus;
+        if (ssd1306_dma_init(&displayDma, &bus, i2c1, SSD1306_STAGE_CAPACITY(SCREEN_WIDTH, SCREEN_HEIGHT)))
+        {
+            ssd1306_set_bus(&display, &bus);
+        }
+        else
+        {
+            printf("DMA indisponivel, usando I2C bloqueante\n");
+        }
     }
 }
 
@@ -65,14 +80,35 @@ void clearDisplay()
 }
 
 /**
- * @brief Displays the content on the SSD1306 display.
+ * @brief Queues the content for the SSD1306 display.
+ *
+ * The changed regions are copied out of the display buffer and handed to the
+ * transport, so drawing the next frame can start right away. If the previous
+ * frame is still in flight the changes stay pending and go out on the next call.
+ *
+ * @return false if the frame could not be queued yet.
+ */
+bool showDisplay()
+{
+    return ssd1306_show_async(&display);
+}
+
+/**
+ * @brief Returns whether a frame is still being transferred to the display.
  *
- * This function calls the ssd1306_display function with the global display
- * variable to update the content shown on the SSD1306 OLED display.
+ * @return true while the DMA transfer started by showDisplay is in flight.
+ */
+bool isDisplayBusy()
+{
+    return ssd1306_flush_busy(&display);
+}
+
+/**
+ * @brief Waits until the frame in flight has reached the display.
  */
-void showDisplay()
+void waitDisplay()
 {
-    ssd1306_show(&display);
+    ssd1306_flush_wait(&display);
 }
 /**
  * @brief Inverts the display colors.
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include "hardware/i2c.h"
 #include "ssd1306.h"
+#include "ssd1306_dma.h"
 
 /** @brief Width of the OLED display (in pixels). */
 #define SCREEN_WIDTH 128
@@ -33,8 +34,14 @@ void initDisplay();
 /** @brief Clears the SSD1306 display. */
 void clearDisplay();
 
-/** @brief Displays the content on the SSD1306 display. */
-void showDisplay();
+/** @brief Queues the content for the SSD1306 display without waiting for the transfer. */
+bool showDisplay();
+
+/** @brief Returns whether a frame is still being transferred to the display. */
+bool isDisplayBusy();
+
+/** @brief Waits until the frame in flight has reached the display. */
+void waitDisplay();
 
 /** @brief Inverts the display colors. */
 void invertDisplay(uint8_t invert);
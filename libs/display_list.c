@@ -0,0 +1,289 @@
+/**
+ * @file display_list.c
+ * @brief Implementation for the network screen display list.
+ *
+ * Three lists rotate between the UI and the renderer: the UI fills the back
+ * list, submitDisplayList() exchanges it with the ready one, and the
+ * renderer exchanges the ready list with the one it drew last. The slot
+ * numbers are exchanged under a hardware spinlock; a list the renderer has
+ * not taken yet is simply replaced by a newer one.
+ */
+
+#include "display_list.h"
+#include "frame_scheduler.h"
+#include "row_cache.h"
+#include "draw.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+volatile uint32_t renderedFrames = 0;
+volatile uint32_t renderBusyPercent = 0;
+
+static display_list_t lists[3];
+/** @brief List being filled by the UI. */
+static int backSlot = 0;
+/** @brief Newest submitted list, exchanged under listLock. */
+static int readySlot = 1;
+/** @brief Whether readySlot holds a list the renderer has not drawn. */
+static bool readyFresh = false;
+/** @brief List drawn last by the renderer. */
+static int frontSlot = 2;
+static spin_lock_t *listLock = NULL;
+
+/**
+ * @brief Takes the newest submitted list (renderer side).
+ *
+ * @return The list, or NULL if nothing new was submitted.
+ */
+static const display_list_t *takeDisplayList()
+{
+    bool fresh;
+
+    uint32_t irq = spin_lock_blocking(listLock);
+    fresh = readyFresh;
+    if (fresh)
+    {
+        int slot = frontSlot;
+        frontSlot = readySlot;
+        readySlot = slot;
+        readyFresh = false;
+    }
+    spin_unlock(listLock, irq);
+
+    return fresh ? &lists[frontSlot] : NULL;
+}
+
+/**
+ * @brief Entry point of core 1: rasterizes and flushes the submitted lists.
+ */
+static void renderCoreMain()
+{
+    flash_safe_execute_core_init(); // O cache de conexões é gravado pelo núcleo 0
+    absolute_time_t windowStart = get_absolute_time();
+    uint64_t windowBusyUs = 0;
+
+    while (true)
+    {
+        const display_list_t *list = takeDisplayList();
+        if (list != NULL)
+        {
+            absolute_time_t start = get_absolute_time();
+            renderDisplayList(list);
+            windowBusyUs += absolute_time_diff_us(start, get_absolute_time());
+
+            // Espera o quadro anterior sair pelo DMA; esse tempo não conta como ocupado
+            if (!showDisplay())
+            {
+                waitDisplay();
+                showDisplay();
+            }
+        }
+        else
+        {
+            // Dorme até o núcleo 0 enviar uma lista (__sev) ou até o fim da janela
+            best_effort_wfe_or_timeout(delayed_by_ms(windowStart, FRAME_STATS_WINDOW_MS));
+        }
+
+        int64_t windowUs = absolute_time_diff_us(windowStart, get_absolute_time());
+        if (windowUs >= FRAME_STATS_WINDOW_MS * 1000)
+        {
+            renderBusyPercent = windowBusyUs * 100 / windowUs;
+            windowBusyUs = 0;
+            windowStart = get_absolute_time();
+        }
+    }
+}
+
+void startRenderer()
+{
+    if (listLock == NULL)
+    {
+        listLock = spin_lock_instance(spin_lock_claim_unused(true));
+    }
+
+#if RENDER_ON_CORE1
+    multicore_launch_core1(renderCoreMain);
+#endif
+}
+
+display_list_t *beginDisplayList()
+{
+    display_list_t *list = &lists[backSlot];
+
+    list->screen = SCREEN_NETWORKS;
+    list->graphCount = 0;
+    list->rowCount = 0;
+    list->cursorVisible = false;
+    list->subtitle[0] = '\0';
+    list->footer[0] = '\0';
+    return list;
+}
+
+bool addDisplayRow(display_list_t *list, const wifi_network_t *network, int y, bool selected)
+{
+    if (list->rowCount >= DISPLAY_LIST_MAX_ROWS)
+    {
+        return false;
+    }
+
+    display_row_t *row = &list->rows[list->rowCount++];
+    setRowContent(&row->content, network);
+    row->y = y;
+    row->selected = selected;
+    return true;
+}
+
+bool submitDisplayList()
+{
+#if RENDER_ON_CORE1
+    uint32_t irq = spin_lock_blocking(listLock);
+    int slot = readySlot;
+    readySlot = backSlot;
+    backSlot = slot;
+    readyFresh = true;
+    spin_unlock(listLock, irq);
+
+    __sev(); // Acorda o núcleo 1
+    return true;
+#else
+    renderDisplayList(&lists[backSlot]);
+    return showDisplay();
+#endif
+}
+
+/**
+ * @brief Height of a spectrum bar for an RSSI.
+ */
+static int spectrumBarHeight(int rssi, int maxHeight)
+{
+    if (rssi == INT8_MIN)
+    {
+        return 0;
+    }
+
+    int height = (rssi + 100) * maxHeight / 70; // -100 dBm a -30 dBm
+    return height < 1 ? 1 : height > maxHeight ? maxHeight : height;
+}
+
+/**
+ * @brief Draws the channel chart: a solid bar for the strongest network on
+ *        each channel, an outline for the power including overlapping channels,
+ *        and the number of networks above it.
+ */
+static void renderSpectrum(const display_list_t *list)
+{
+    const int columnWidth = 9;
+    const int left = (SCREEN_WIDTH - SPECTRUM_CHANNELS * columnWidth) / 2;
+    const int countY = 18;
+    const int bottom = SCREEN_HEIGHT - 2 * TEXT_HEIGHT - 3; // Acima dos rótulos e do rodapé
+    const int maxHeight = bottom - (countY + TEXT_HEIGHT + 1);
+
+    for (int i = 0; i < SPECTRUM_CHANNELS; i++)
+    {
+        const spectrum_bar_t *bar = &list->spectrum[i];
+        int x = left + i * columnWidth;
+
+        int spread = spectrumBarHeight(bar->spread, maxHeight);
+        if (spread > 0)
+        {
+            ssd1306_draw_empty_square(&display, x + 1, bottom - spread, columnWidth - 3, spread);
+        }
+
+        int strongest = spectrumBarHeight(bar->strongest, maxHeight);
+        if (strongest > 0)
+        {
+            drawRectangle(x + 2, bottom - strongest, columnWidth - 4, strongest);
+        }
+
+        if (bar->count > 0)
+        {
+            char count[2] = { bar->count > 9 ? '+' : '0' + bar->count, '\0' };
+            drawText(x + 2, countY, count);
+        }
+    }
+
+    // Eixo com os canais que não se sobrepõem
+    drawLine(left, bottom, left + SPECTRUM_CHANNELS * columnWidth - 1, bottom);
+    drawText(left + 1, bottom + 1, "1");
+    drawText(left + 5 * columnWidth - 1, bottom + 1, "6");
+    drawText(left + 10 * columnWidth - 4, bottom + 1, "11");
+}
+
+/**
+ * @brief Draws the RSSI graph of the tracked network, newest sample on the right.
+ */
+static void renderGraph(const display_list_t *list)
+{
+    const int top = 18;
+    const int bottom = SCREEN_HEIGHT - TEXT_HEIGHT - 3;
+    const int step = 2;
+    const int right = (SCREEN_WIDTH + (TRACK_GRAPH_POINTS - 1) * step) / 2;
+    ssd1306_point_t points[TRACK_GRAPH_POINTS];
+
+    for (int i = 0; i < list->graphCount; i++)
+    {
+        int rssi = list->graph[i];
+        if (rssi < -100) rssi = -100;
+        if (rssi > -30) rssi = -30;
+
+        points[i].x = right - (list->graphCount - 1 - i) * step;
+        points[i].y = bottom - (rssi + 100) * (bottom - top) / 70; // -100 dBm a -30 dBm
+    }
+
+    // Linhas de referência em -50 e -80 dBm, tracejadas
+    for (int x = right - (TRACK_GRAPH_POINTS - 1) * step; x <= right; x += 4)
+    {
+        ssd1306_draw_pixel(&display, x, bottom - 50 * (bottom - top) / 70);
+        ssd1306_draw_pixel(&display, x, bottom - 20 * (bottom - top) / 70);
+    }
+
+    if (list->graphCount == 1)
+    {
+        drawRectangle(points[0].x - 1, points[0].y - 1, 3, 3);
+    }
+    else
+    {
+        drawPolyline(points, list->graphCount);
+    }
+}
+
+void renderDisplayList(const display_list_t *list)
+{
+    // As linhas em cache seguem válidas enquanto a rede continua na tabela
+    invalidateRemovedRows(&list->removed);
+
+    clearDisplay();
+
+    if (list->screen == SCREEN_SPECTRUM)
+    {
+        renderSpectrum(list);
+    }
+    else if (list->screen == SCREEN_TRACKING)
+    {
+        renderGraph(list);
+    }
+
+    // Linhas pré-renderizadas: SSID, sinal (RSSI) e barra de seleção
+    for (int i = 0; i < list->rowCount; i++)
+    {
+        const display_row_t *row = &list->rows[i];
+        drawNetworkRow(&row->content, row->y, row->selected);
+    }
+
+    if (list->cursorVisible)
+    {
+        drawRowCursor(list->cursorX, list->cursorY);
+    }
+
+    drawAppHeaderWithSubtitle((char *)list->subtitle);
+
+    // Rodapé com os detalhes da rede selecionada
+    int y = SCREEN_HEIGHT - TEXT_HEIGHT - 1;
+    drawClearRectangle(0, y, SCREEN_WIDTH, SCREEN_HEIGHT); // Limpa a área do texto
+    drawLine(0, y, SCREEN_WIDTH, y); // Linha horizontal
+    drawText(0, y + 1, (char *)list->footer);
+
+    renderedFrames++;
+}
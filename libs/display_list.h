@@ -0,0 +1,106 @@
+/**
+ * @file display_list.h
+ * @brief Header file for the network screen display list.
+ *
+ * The UI describes a frame as a short list of what is on screen (rows and
+ * cursor, channel bars or an RSSI graph, header and footer text) and the renderer rasterizes it into the
+ * display buffer and flushes it. With RENDER_ON_CORE1 the renderer runs on
+ * core 1 and lists are handed over through a triple buffer, so the UI
+ * never waits for the rasterizer or the I2C bus.
+ */
+
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include "patro_wifi_scanner.h"
+#include "network_store.h"
+#include "row_cache.h"
+
+/** @brief Rasterizes and flushes frames on core 1. */
+#ifndef RENDER_ON_CORE1
+#define RENDER_ON_CORE1 0
+#endif
+
+/** @brief Maximum number of network rows in a display list. */
+#define DISPLAY_LIST_MAX_ROWS 8
+
+/** @brief Number of 2.4 GHz channels drawn on the spectrum screen (1 to 13). */
+#define SPECTRUM_CHANNELS 13
+
+/** @brief Number of RSSI samples drawn on the tracking graph. */
+#define TRACK_GRAPH_POINTS 60
+
+/** @brief Screens the display list can describe. */
+typedef enum {
+    SCREEN_NETWORKS,
+    SCREEN_SPECTRUM,
+    SCREEN_TRACKING,
+    SCREEN_COUNT
+} display_screen_t;
+
+/** @brief A channel of the spectrum chart. */
+typedef struct {
+    int8_t strongest; // RSSI da rede mais forte no canal, INT8_MIN se vazio
+    int8_t spread;    // Potência somada com a dos canais sobrepostos, em dBm, INT8_MIN se nada
+    uint8_t count;    // Redes no canal
+} spectrum_bar_t;
+
+/** @brief A network row of the list. */
+typedef struct {
+    row_content_t content; // Cópia do que a linha mostra, o snapshot pode mudar antes do desenho
+    int16_t y;             // Posição do texto da linha
+    bool selected;
+} display_row_t;
+
+/** @brief Everything needed to draw one frame of the network screen. */
+typedef struct {
+    display_screen_t screen;
+    spectrum_bar_t spectrum[SPECTRUM_CHANNELS];
+    int8_t graph[TRACK_GRAPH_POINTS]; // Amostras de RSSI, da mais antiga para a mais nova
+    uint8_t graphCount;
+    display_row_t rows[DISPLAY_LIST_MAX_ROWS];
+    uint8_t rowCount;
+    bool cursorVisible;
+    int16_t cursorX;
+    int16_t cursorY;
+    char subtitle[32];        // Segunda linha do cabeçalho
+    char footer[32];          // Texto do rodapé
+    removed_log_t removed;    // Redes removidas, cujas linhas em cache não servem mais
+} display_list_t;
+
+/** @brief Frames rasterized by the renderer. */
+extern volatile uint32_t renderedFrames;
+/** @brief Percentage of the last statistics window core 1 spent rendering (RENDER_ON_CORE1). */
+extern volatile uint32_t renderBusyPercent;
+
+/** @brief Prepares the display list buffers and, with RENDER_ON_CORE1, starts the renderer on core 1. */
+void startRenderer();
+
+/**
+ * @brief Returns an empty display list to be filled and passed to submitDisplayList.
+ */
+display_list_t *beginDisplayList();
+
+/**
+ * @brief Adds a network row to a display list.
+ *
+ * @return false if the list is full.
+ */
+bool addDisplayRow(display_list_t *list, const wifi_network_t *network, int y, bool selected);
+
+/**
+ * @brief Hands the list returned by beginDisplayList to the renderer.
+ *
+ * Without RENDER_ON_CORE1 the list is rendered and flushed right away.
+ *
+ * @return false if the frame could not be sent because the previous one
+ *         was still being transferred; the caller should submit again.
+ */
+bool submitDisplayList();
+
+/**
+ * @brief Rasterizes a display list into the display buffer.
+ */
+void renderDisplayList(const display_list_t *list);
+
+#endif // DISPLAY_LIST_H
@@ -37,4 +37,24 @@ void drawClearRectangle(int x, int y, int width, int height)
 void drawRectangle(int x, int y, int width, int height)
 {
     ssd1306_draw_square(&display, x, y, width, height);
+}
+
+void drawInvertRectangle(int x, int y, int width, int height)
+{
+    ssd1306_fill_rect(&display, x, y, width, height, SSD1306_ROP_XOR);
+}
+
+void drawCircle(int x, int y, int radius)
+{
+    ssd1306_draw_circle(&display, x, y, radius);
+}
+
+void drawArc(int x, int y, int radius, int startAngle, int endAngle)
+{
+    ssd1306_draw_arc(&display, x, y, radius, startAngle, endAngle);
+}
+
+void drawPolyline(const ssd1306_point_t *points, int count)
+{
+    ssd1306_draw_polyline(&display, points, count);
 }
\ No newline at end of file
@@ -26,4 +26,42 @@ void drawLine(int x1, int y1, int x2, int y2);
 void drawClearRectangle(int x, int y, int width, int height);
 void drawRectangle(int x, int y, int width, int height);
 
+/**
+ * @brief Inverts every pixel inside a rectangle, e.g. to highlight a selection.
+ *
+ * @param x X-coordinate of the top-left corner.
+ * @param y Y-coordinate of the top-left corner.
+ * @param width Width of the rectangle.
+ * @param height Height of the rectangle.
+ */
+void drawInvertRectangle(int x, int y, int width, int height);
+
+/**
+ * @brief Draws a circle outline.
+ *
+ * @param x X-coordinate of the center.
+ * @param y Y-coordinate of the center.
+ * @param radius Radius of the circle.
+ */
+void drawCircle(int x, int y, int radius);
+
+/**
+ * @brief Draws a circular arc, angles in degrees counterclockwise from the right.
+ *
+ * @param x X-coordinate of the center.
+ * @param y Y-coordinate of the center.
+ * @param radius Radius of the arc.
+ * @param startAngle Angle where the arc starts.
+ * @param endAngle Angle where the arc ends.
+ */
+void drawArc(int x, int y, int radius, int startAngle, int endAngle);
+
+/**
+ * @brief Draws line segments connecting consecutive points, e.g. a signal graph.
+ *
+ * @param points Points to connect.
+ * @param count Number of points.
+ */
+void drawPolyline(const ssd1306_point_t *points, int count);
+
 #endif // DRAW_H
\ No newline at end of file
@@ -0,0 +1,94 @@
+/**
+ * @file frame_scheduler.c
+ * @brief Implementation for the frame pacing module.
+ *
+ * The loop runs once per tick. Between ticks the core waits for an event
+ * or the tick deadline (WFE), so it sleeps instead of spinning and the
+ * animation speed no longer depends on how fast the display flushes.
+ */
+
+#include "frame_scheduler.h"
+#include "pico/cyw43_arch.h"
+
+void initFrameScheduler(frame_scheduler_t *fs, uint32_t fps)
+{
+    absolute_time_t now = get_absolute_time();
+
+    fs->periodUs = 1000000 / (fps > 0 ? fps : 1);
+    fs->nextTick = delayed_by_us(now, fs->periodUs);
+    fs->frameStart = now;
+    fs->windowStart = now;
+    fs->windowFrames = 0;
+    fs->windowBusyUs = 0;
+    fs->windowIdleUs = 0;
+
+    fs->frameTimeUs = 0;
+    fs->avgFrameTimeUs = 0;
+    fs->fps = 0;
+    fs->idlePercent = 0;
+    fs->totalFrames = 0;
+}
+
+void beginFrame(frame_scheduler_t *fs)
+{
+    fs->frameStart = get_absolute_time();
+}
+
+void endFrame(frame_scheduler_t *fs)
+{
+    fs->frameTimeUs = absolute_time_diff_us(fs->frameStart, get_absolute_time());
+    fs->windowBusyUs += fs->frameTimeUs;
+    fs->windowFrames++;
+    fs->totalFrames++;
+}
+
+/**
+ * @brief Closes the statistics window when it is over.
+ *
+ * @return true if a window was closed.
+ */
+static bool updateFrameStats(frame_scheduler_t *fs, absolute_time_t now)
+{
+    int64_t windowUs = absolute_time_diff_us(fs->windowStart, now);
+    if (windowUs < FRAME_STATS_WINDOW_MS * 1000)
+    {
+        return false;
+    }
+
+    fs->fps = (uint32_t)((fs->windowFrames * 1000000ull + windowUs / 2) / windowUs);
+    fs->avgFrameTimeUs = fs->windowFrames ? (uint32_t)(fs->windowBusyUs / fs->windowFrames) : 0;
+    fs->idlePercent = (uint32_t)(fs->windowIdleUs * 100 / windowUs);
+
+    fs->windowStart = now;
+    fs->windowFrames = 0;
+    fs->windowBusyUs = 0;
+    fs->windowIdleUs = 0;
+    return true;
+}
+
+bool waitForNextTick(frame_scheduler_t *fs)
+{
+    absolute_time_t idleStart = get_absolute_time();
+
+    while (!time_reached(fs->nextTick))
+    {
+#if PICO_CYW43_ARCH_POLL
+        cyw43_arch_poll();
+        cyw43_arch_wait_for_work_until(fs->nextTick);
+#else
+        best_effort_wfe_or_timeout(fs->nextTick);
+#endif
+    }
+
+    absolute_time_t now = get_absolute_time();
+    fs->windowIdleUs += absolute_time_diff_us(idleStart, now);
+
+    // Se o loop atrasou mais de um tick, recomeça a contagem em vez de acumular atraso
+    fs->nextTick = delayed_by_us(fs->nextTick, fs->periodUs);
+    if (absolute_time_diff_us(now, fs->nextTick) < 0)
+    {
+        fs->nextTick = delayed_by_us(now, fs->periodUs);
+    }
+
+    return updateFrameStats(fs, now);
+}
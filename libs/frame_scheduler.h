@@ -0,0 +1,61 @@
+/**
+ * @file frame_scheduler.h
+ * @brief Header file for the frame pacing module.
+ *
+ * Paces the main loop at a fixed tick rate, sleeps between ticks and keeps
+ * frame time, frame rate and idle statistics.
+ */
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include "pico/stdlib.h"
+
+/** @brief Default number of loop ticks (and maximum frames) per second. */
+#ifndef TARGET_FPS
+#define TARGET_FPS 30
+#endif
+
+/** @brief Length of the window used for the frame statistics. */
+#define FRAME_STATS_WINDOW_MS 1000
+
+/** @brief Frame pacing state and statistics. */
+typedef struct {
+    uint32_t periodUs;           // Duração de um tick
+    absolute_time_t nextTick;    // Início do próximo tick
+    absolute_time_t frameStart;  // Início do quadro em andamento
+    absolute_time_t windowStart; // Início da janela de estatísticas
+    uint32_t windowFrames;       // Quadros desenhados na janela atual
+    uint64_t windowBusyUs;       // Tempo gasto desenhando na janela atual
+    uint64_t windowIdleUs;       // Tempo dormindo na janela atual
+
+    uint32_t frameTimeUs;        // Duração do último quadro desenhado
+    uint32_t avgFrameTimeUs;     // Duração média dos quadros da última janela
+    uint32_t fps;                // Quadros desenhados na última janela, por segundo
+    uint32_t idlePercent;        // Porcentagem da última janela passada dormindo
+    uint32_t totalFrames;        // Quadros desenhados desde o início
+} frame_scheduler_t;
+
+/**
+ * @brief Initializes the scheduler.
+ *
+ * @param fs Scheduler to initialize.
+ * @param fps Target tick rate.
+ */
+void initFrameScheduler(frame_scheduler_t *fs, uint32_t fps);
+
+/** @brief Marks the start of a frame that is going to be drawn. */
+void beginFrame(frame_scheduler_t *fs);
+
+/** @brief Marks the end of the frame started with beginFrame. */
+void endFrame(frame_scheduler_t *fs);
+
+/**
+ * @brief Sleeps until the next tick, servicing the Wi-Fi driver in poll mode.
+ *
+ * @param fs Scheduler.
+ * @return true when a new statistics window was completed during this tick.
+ */
+bool waitForNextTick(frame_scheduler_t *fs);
+
+#endif // FRAME_SCHEDULER_H
@@ -0,0 +1,37 @@
+/**
+ * @file sync.h
+ * @brief Host stand-in for the hardware spinlocks, backed by a pthread mutex.
+ */
+
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+#include <pthread.h>
+
+typedef pthread_mutex_t spin_lock_t;
+
+static spin_lock_t hostSpinLock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline int spin_lock_claim_unused(bool required)
+{
+    return 0;
+}
+
+static inline spin_lock_t *spin_lock_instance(uint lock_num)
+{
+    return &hostSpinLock;
+}
+
+static inline uint32_t spin_lock_blocking(spin_lock_t *lock)
+{
+    pthread_mutex_lock(lock);
+    return 0;
+}
+
+static inline void spin_unlock(spin_lock_t *lock, uint32_t saved_irq)
+{
+    pthread_mutex_unlock(lock);
+}
+
+#endif // HOST_HARDWARE_SYNC_H
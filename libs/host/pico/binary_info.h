@@ -0,0 +1,4 @@
+/**
+ * @file binary_info.h
+ * @brief Host stand-in for pico/binary_info.h; the host build has no binary info.
+ */
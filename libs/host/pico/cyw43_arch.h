@@ -0,0 +1,26 @@
+/**
+ * @file cyw43_arch.h
+ * @brief Host stand-in for the cyw43 scan result used by the scan ring.
+ */
+
+#ifndef HOST_PICO_CYW43_ARCH_H
+#define HOST_PICO_CYW43_ARCH_H
+
+#include "pico/stdlib.h"
+
+#define CYW43_AUTH_OPEN 0
+#define CYW43_AUTH_WPA_TKIP_PSK 0x00200002
+#define CYW43_AUTH_WPA2_AES_PSK 0x00400004
+#define CYW43_AUTH_WPA2_MIXED_PSK 0x00400006
+
+/** @brief Fields of the driver's scan result read by the scan ring. */
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t ssid_len;
+    uint8_t ssid[32];
+    uint16_t channel;
+    uint8_t auth_mode;
+    int16_t rssi;
+} cyw43_ev_scan_result_t;
+
+#endif // HOST_PICO_CYW43_ARCH_H
@@ -0,0 +1,125 @@
+/**
+ * @file input.c
+ * @brief Implementation for the joystick input events.
+ */
+
+#include "input.h"
+#include "analog.h"
+#include <stdlib.h>
+
+volatile uint32_t inputEventsDropped = 0;
+
+/** @brief Events written by the timer and read by the main loop. */
+static input_event_t queue[INPUT_QUEUE_SIZE];
+static volatile uint32_t queueHead = 0;
+static volatile uint32_t queueTail = 0;
+
+static repeating_timer_t inputTimer;
+
+/** @brief Direction held, or -1 with the joystick centered. */
+static int heldDirection = -1;
+/** @brief When the next repeat is due, in ms since boot. */
+static uint32_t nextRepeatMs = 0;
+/** @brief Interval until the next repeat. */
+static uint32_t repeatIntervalMs = INPUT_REPEAT_MS;
+/** @brief Repeats since the direction was pushed. */
+static uint32_t repeatCount = 0;
+
+/**
+ * @brief Queues an event; drops it when the main loop is behind.
+ */
+static void pushEvent(uint32_t timeMs, bool repeat, uint8_t step)
+{
+    uint32_t head = queueHead;
+    if (head - queueTail >= INPUT_QUEUE_SIZE)
+    {
+        inputEventsDropped++;
+        return;
+    }
+
+    input_event_t *event = &queue[head % INPUT_QUEUE_SIZE];
+    event->timeMs = timeMs;
+    event->direction = heldDirection;
+    event->repeat = repeat;
+    event->step = step;
+    __dmb(); // Publica o evento só depois de escrito
+    queueHead = head + 1;
+}
+
+/**
+ * @brief Converts the axes into a direction; the stronger axis wins.
+ *
+ * @return The direction, or -1 with the joystick centered.
+ */
+static int getDirection()
+{
+    if (analog_x == 0 && analog_y == 0)
+    {
+        return -1;
+    }
+    if (abs(analog_y) >= abs(analog_x))
+    {
+        return analog_y < 0 ? INPUT_UP : INPUT_DOWN;
+    }
+    return analog_x > 0 ? INPUT_RIGHT : INPUT_LEFT;
+}
+
+/**
+ * @brief Reads the joystick and produces the press and repeat events.
+ */
+static bool pollInput(repeating_timer_t *timer)
+{
+    updateAxis(); // Média do anel da DMA, sem esperar o ADC
+    uint32_t nowMs = to_ms_since_boot(get_absolute_time());
+    int direction = getDirection();
+
+    if (direction != heldDirection)
+    {
+        // Novo toque (ou soltou): a repetição recomeça devagar
+        heldDirection = direction;
+        repeatCount = 0;
+        repeatIntervalMs = INPUT_REPEAT_MS;
+        nextRepeatMs = nowMs + INPUT_REPEAT_DELAY_MS;
+        if (direction >= 0)
+        {
+            pushEvent(nowMs, false, 1);
+        }
+    }
+    else if (direction >= 0 && (int32_t)(nowMs - nextRepeatMs) >= 0)
+    {
+        // Mantido: repete cada vez mais rápido, e cada evento anda mais linhas
+        repeatCount++;
+        uint32_t doublings = repeatCount / INPUT_ACCEL_REPEATS;
+        uint32_t step = doublings < 8 ? 1u << doublings : INPUT_MAX_STEP;
+        pushEvent(nowMs, true, step > INPUT_MAX_STEP ? INPUT_MAX_STEP : step);
+
+        nextRepeatMs += repeatIntervalMs;
+        repeatIntervalMs = repeatIntervalMs * 7 / 8;
+        if (repeatIntervalMs < INPUT_REPEAT_MIN_MS)
+        {
+            repeatIntervalMs = INPUT_REPEAT_MIN_MS;
+        }
+    }
+    return true; // Continua repetindo
+}
+
+void startInput()
+{
+    // Período negativo: intervalo entre inícios, sem acumular o tempo da leitura
+    add_repeating_timer_ms(-INPUT_POLL_MS, pollInput, NULL, &inputTimer);
+}
+
+bool getInputEvent(input_event_t *event)
+{
+    uint32_t tail = queueTail;
+    if (tail == queueHead)
+    {
+        return false;
+    }
+    __dmb(); // Lê o evento só depois de ver o índice que o cobre
+
+    *event = queue[tail % INPUT_QUEUE_SIZE];
+    __dmb(); // Termina de ler antes de devolver a posição ao timer
+    queueTail = tail + 1;
+    return true;
+}
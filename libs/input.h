@@ -0,0 +1,82 @@
+/**
+ * @file input.h
+ * @brief Header file for the joystick input events.
+ *
+ * A repeating timer reads the filtered joystick every INPUT_POLL_MS and
+ * turns it into timestamped events: a press when a direction is pushed,
+ * then repeats while it is held. Repeats come faster the longer the
+ * direction is held, and after INPUT_ACCEL_REPEATS repeats each event
+ * moves more rows, for long lists. The timing depends only on the clock,
+ * not on how fast the screen is drawn; the main loop just takes the
+ * queued events.
+ */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "pico/stdlib.h"
+
+/** @brief Period of the joystick reading. */
+#ifndef INPUT_POLL_MS
+#define INPUT_POLL_MS 10
+#endif
+
+/** @brief Time a direction must be held before the first repeat. */
+#ifndef INPUT_REPEAT_DELAY_MS
+#define INPUT_REPEAT_DELAY_MS 400
+#endif
+
+/** @brief Interval of the first repeats. */
+#ifndef INPUT_REPEAT_MS
+#define INPUT_REPEAT_MS 160
+#endif
+
+/** @brief Shortest interval between repeats. */
+#ifndef INPUT_REPEAT_MIN_MS
+#define INPUT_REPEAT_MIN_MS 40
+#endif
+
+/** @brief Repeats after which the step of each event doubles. */
+#ifndef INPUT_ACCEL_REPEATS
+#define INPUT_ACCEL_REPEATS 10
+#endif
+
+/** @brief Largest step of an event. */
+#ifndef INPUT_MAX_STEP
+#define INPUT_MAX_STEP 4
+#endif
+
+/** @brief Events kept until the main loop takes them, a power of two. */
+#define INPUT_QUEUE_SIZE 16
+
+/** @brief Joystick directions. */
+typedef enum {
+    INPUT_UP,
+    INPUT_DOWN,
+    INPUT_LEFT,
+    INPUT_RIGHT
+} input_direction_t;
+
+/** @brief Joystick event. */
+typedef struct {
+    uint32_t timeMs;               // Momento do evento, em ms desde o boot
+    input_direction_t direction;
+    bool repeat;                   // false no primeiro evento de cada toque
+    uint8_t step;                  // Linhas a mover, cresce enquanto a direção é mantida
+} input_event_t;
+
+/** @brief Events dropped because the queue was full. */
+extern volatile uint32_t inputEventsDropped;
+
+/** @brief Starts reading the joystick; call after initAnalog(). */
+void startInput();
+
+/**
+ * @brief Takes the oldest joystick event.
+ *
+ * @param event Receives the event.
+ * @return false if no event is waiting.
+ */
+bool getInputEvent(input_event_t *event);
+
+#endif // INPUT_H
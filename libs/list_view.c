@@ -0,0 +1,112 @@
+/**
+ * @file list_view.c
+ * @brief Implementation for the virtualized list widget.
+ *
+ * Row positions are derived from the scroll offset, so the visible window
+ * is found with a couple of divisions instead of walking every item.
+ */
+
+#include "list_view.h"
+#include "utils.h"
+
+/**
+ * @brief Integer division rounding towards negative infinity.
+ */
+static int floorDiv(int a, int b)
+{
+    int q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0)))
+    {
+        q--;
+    }
+    return q;
+}
+
+void initListView(list_view_t *view, int top, int viewTop, int viewBottom, int rowHeight, int textHeight)
+{
+    view->top = top;
+    view->viewTop = viewTop;
+    view->viewBottom = viewBottom;
+    view->rowHeight = rowHeight;
+    view->textHeight = textHeight;
+    view->scrollY = 0;
+    view->scrollStep = 1;
+    view->count = 0;
+    view->selected = 0;
+    view->paged = false;
+}
+
+void setListViewItems(list_view_t *view, int count, int selected)
+{
+    view->count = count;
+    if (selected >= count) selected = count - 1;
+    if (selected < 0) selected = 0;
+    view->selected = selected;
+}
+
+int getListViewRowsPerPage(const list_view_t *view)
+{
+    int rows = (view->viewBottom - view->viewTop) / view->rowHeight;
+    return rows > 0 ? rows : 1;
+}
+
+int getListViewPage(const list_view_t *view)
+{
+    return view->selected / getListViewRowsPerPage(view);
+}
+
+int getListViewPageCount(const list_view_t *view)
+{
+    int rows = getListViewRowsPerPage(view);
+    return (view->count + rows - 1) / rows;
+}
+
+/**
+ * @brief Scroll position the list is moving towards.
+ */
+static int getScrollTarget(const list_view_t *view)
+{
+    int rows = getListViewRowsPerPage(view);
+    int target;
+
+    if (view->paged)
+    {
+        target = getListViewPage(view) * rows;
+    }
+    else
+    {
+        // Mantém a seleção na tela sem rolar além do último item
+        target = view->selected;
+        if (target > view->count - rows) target = view->count - rows;
+    }
+    if (target < 0) target = 0;
+
+    return target * view->rowHeight;
+}
+
+void updateListView(list_view_t *view)
+{
+    view->scrollY = approach(view->scrollY, getScrollTarget(view), view->scrollStep);
+}
+
+bool isListViewScrolling(const list_view_t *view)
+{
+    return view->scrollY != getScrollTarget(view);
+}
+
+int getListViewRowY(const list_view_t *view, int index)
+{
+    return view->top - view->scrollY + index * view->rowHeight;
+}
+
+void getListViewVisibleRange(const list_view_t *view, int *first, int *last)
+{
+    int origin = view->top - view->scrollY;
+
+    // Uma linha ocupa [y - 1, y + textHeight), contando a barra de seleção
+    *first = floorDiv(view->viewTop - view->textHeight - origin, view->rowHeight) + 1;
+    *last = floorDiv(view->viewBottom - origin, view->rowHeight);
+
+    if (*first < 0) *first = 0;
+    if (*last > view->count - 1) *last = view->count - 1;
+}
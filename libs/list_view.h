@@ -0,0 +1,79 @@
+/**
+ * @file list_view.h
+ * @brief Header file for the virtualized list widget.
+ *
+ * The widget keeps the scroll position of a vertical list and works out
+ * which rows intersect the viewport, so only those are drawn no matter
+ * how many items the list has.
+ */
+
+#ifndef LIST_VIEW_H
+#define LIST_VIEW_H
+
+#include <stdbool.h>
+
+/** @brief State of a scrolling list. */
+typedef struct {
+    int top;          // Y da primeira linha de texto com rolagem zero
+    int viewTop;      // Primeira linha visível da área da lista
+    int viewBottom;   // Primeira linha abaixo da área da lista
+    int rowHeight;    // Distância entre linhas
+    int textHeight;   // Altura desenhada de cada linha, a partir do seu Y
+    int scrollY;      // Posição de rolagem atual
+    int scrollStep;   // Pixels por quadro da animação de rolagem
+    int count;        // Número de itens
+    int selected;     // Item selecionado
+    bool paged;       // Rola por páginas inteiras em vez de seguir a seleção
+} list_view_t;
+
+/**
+ * @brief Initializes a list view.
+ *
+ * @param view List to initialize.
+ * @param top Y-coordinate of the first row when not scrolled.
+ * @param viewTop First visible line of the list area.
+ * @param viewBottom First line below the list area.
+ * @param rowHeight Distance between rows.
+ * @param textHeight Height drawn by a row below its Y-coordinate.
+ */
+void initListView(list_view_t *view, int top, int viewTop, int viewBottom, int rowHeight, int textHeight);
+
+/**
+ * @brief Sets the number of items and the selection, keeping both in range.
+ */
+void setListViewItems(list_view_t *view, int count, int selected);
+
+/**
+ * @brief Moves the scroll position one animation step towards the selection.
+ */
+void updateListView(list_view_t *view);
+
+/**
+ * @brief Returns whether the scroll animation has not reached the selection yet.
+ */
+bool isListViewScrolling(const list_view_t *view);
+
+/**
+ * @brief Computes the range of rows that intersect the viewport.
+ *
+ * @param view List view.
+ * @param first First visible index.
+ * @param last Last visible index, smaller than first when nothing is visible.
+ */
+void getListViewVisibleRange(const list_view_t *view, int *first, int *last);
+
+/**
+ * @brief Returns the Y-coordinate where a row is drawn.
+ */
+int getListViewRowY(const list_view_t *view, int index);
+
+/** @brief Number of rows that fit entirely in the viewport. */
+int getListViewRowsPerPage(const list_view_t *view);
+
+/** @brief Page (0-based) that contains the selection. */
+int getListViewPage(const list_view_t *view);
+
+/** @brief Number of pages needed for all items. */
+int getListViewPageCount(const list_view_t *view);
+
+#endif // LIST_VIEW_H
@@ -0,0 +1,672 @@
+/**
+ * @file network_store.c
+ * @brief Implementation for the scanned network table.
+ *
+ * The index is a linear-probing hash table of int16_t entries pointing into
+ * networks[]. It is kept at most half full, so lookups from the scan
+ * callback touch one or two slots instead of comparing every BSSID.
+ *
+ * The heap holds positions in networks[] ordered by RSSI, weakest on top,
+ * so a full table decides in O(log K) whether a new result replaces the
+ * weakest entry.
+ *
+ * The display order is a separate array of positions sorted by RSSI,
+ * strongest first. An entry whose RSSI changes is taken out and inserted
+ * again, so only 16-bit positions move and the entries stay put.
+ *
+ * Scan results are merged into a working table that the UI never reads.
+ * publishNetworks() copies its entries, in display order, into one of three
+ * snapshots and acquireNetworks() hands the newest snapshot to the UI
+ * (triple buffering).
+ * The slot numbers are exchanged under a hardware spinlock, so the scan
+ * pipeline and the UI can run on different cores and neither waits for
+ * the other to finish with a snapshot.
+ */
+
+#include "network_store.h"
+#include "rssi_stats.h"
+#include "hardware/sync.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/** @brief Networks with their index, heap and display order. */
+typedef struct {
+    wifi_network_t networks[MAX_RESULTS];
+    int count;
+
+    /** @brief Hash index: position in networks[], or -1 for an empty slot. */
+    int16_t index[NETWORK_INDEX_SIZE];
+
+    /** @brief Min-heap of positions in networks[], keyed on RSSI. */
+    int16_t heap[MAX_RESULTS];
+    /** @brief Position of each network in the heap. */
+    int16_t heapPos[MAX_RESULTS];
+
+    /** @brief Positions in networks[] sorted by RSSI, strongest first. */
+    int16_t order[MAX_RESULTS];
+    /** @brief Rank of each network in order. */
+    int16_t rankOf[MAX_RESULTS];
+    /** @brief Number of entries in order. */
+    int orderLength;
+
+    /** @brief Aggregates by channel; index 0 is unused. */
+    channel_stats_t channels[CHANNEL_COUNT + 1];
+
+    /** @brief Networks removed or evicted, so cached rows of them can be dropped. */
+    removed_log_t removed;
+} network_table_t;
+
+/** @brief Scan side state of an entry of the working table, never published. */
+typedef struct {
+    rssi_stats_t stats;
+    uint32_t lastSeenScan; // Última varredura em que a rede apareceu
+    int8_t sweepRssi;      // RSSI suavizado ao fim da última varredura, para medir a variação
+} scan_entry_t;
+
+/** @brief What the UI reads: the networks in display order and their aggregates. */
+typedef struct {
+    wifi_network_t networks[MAX_RESULTS];
+    int count;
+    channel_stats_t channels[CHANNEL_COUNT + 1];
+    removed_log_t removed;
+} network_snapshot_t;
+
+/** @brief Table the scan results are merged into. */
+static network_table_t scan;
+/** @brief Scan side state of each entry of the working table, by position in networks[]. */
+static scan_entry_t scanEntries[MAX_RESULTS];
+/** @brief Set when the working table differs from the last published snapshot. */
+static bool scanChanged = false;
+
+static network_snapshot_t snapshots[3];
+/** @brief Snapshot owned by the producer, filled by publishNetworks(). */
+static int backSlot = 0;
+/** @brief Newest published snapshot, exchanged under snapshotLock. */
+static int readySlot = 1;
+/** @brief Whether readySlot holds a snapshot the UI has not taken yet. */
+static bool readyFresh = false;
+/** @brief Snapshot owned by the UI. */
+static int shownSlot = 2;
+/** @brief Snapshot read by the lookups below. */
+static network_snapshot_t *shown = &snapshots[2];
+static spin_lock_t *snapshotLock = NULL;
+
+uint32_t networksDropped = 0;
+uint32_t networksEvicted = 0;
+uint32_t networksExpired = 0;
+
+/** @brief Current scan generation. */
+static uint32_t scanGeneration = 0;
+
+/** @brief Networks added and removed since beginNetworkScan(). */
+static uint16_t sweepAdded = 0;
+static uint16_t sweepLost = 0;
+
+/**
+ * @brief FNV-1a hash of a BSSID.
+ */
+static uint32_t hashBssid(const uint8_t *bssid)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < 6; i++)
+    {
+        hash ^= bssid[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Finds the index slot holding a BSSID or the empty slot where it would go.
+ */
+static int findSlot(const network_table_t *t, const uint8_t *bssid)
+{
+    uint32_t slot = hashBssid(bssid) & (NETWORK_INDEX_SIZE - 1);
+
+    while (t->index[slot] >= 0 &&
+           memcmp(t->networks[t->index[slot]].bssid, bssid, sizeof(t->networks[0].bssid)) != 0)
+    {
+        slot = (slot + 1) & (NETWORK_INDEX_SIZE - 1);
+    }
+    return slot;
+}
+
+/**
+ * @brief Empties an index slot, shifting later entries of the probe run back.
+ */
+static void removeFromIndex(network_table_t *t, uint32_t slot)
+{
+    const uint32_t mask = NETWORK_INDEX_SIZE - 1;
+    uint32_t hole = slot;
+    uint32_t next = slot;
+
+    t->index[hole] = -1;
+    while (true)
+    {
+        next = (next + 1) & mask;
+        if (t->index[next] < 0)
+        {
+            return;
+        }
+
+        // Uma entrada só pode ocupar o buraco se sua posição ideal não estiver entre ele e ela
+        uint32_t home = hashBssid(t->networks[t->index[next]].bssid) & mask;
+        bool stays = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!stays)
+        {
+            t->index[hole] = t->index[next];
+            t->index[next] = -1;
+            hole = next;
+        }
+    }
+}
+
+static void heapSwap(network_table_t *t, int a, int b)
+{
+    int16_t tmp = t->heap[a];
+    t->heap[a] = t->heap[b];
+    t->heap[b] = tmp;
+    t->heapPos[t->heap[a]] = a;
+    t->heapPos[t->heap[b]] = b;
+}
+
+static void siftUp(network_table_t *t, int pos)
+{
+    while (pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if (t->networks[t->heap[parent]].rssi <= t->networks[t->heap[pos]].rssi)
+        {
+            break;
+        }
+        heapSwap(t, pos, parent);
+        pos = parent;
+    }
+}
+
+static void siftDown(network_table_t *t, int pos)
+{
+    while (true)
+    {
+        int child = 2 * pos + 1;
+        if (child >= t->count)
+        {
+            break;
+        }
+        if (child + 1 < t->count && t->networks[t->heap[child + 1]].rssi < t->networks[t->heap[child]].rssi)
+        {
+            child++;
+        }
+        if (t->networks[t->heap[pos]].rssi <= t->networks[t->heap[child]].rssi)
+        {
+            break;
+        }
+        heapSwap(t, pos, child);
+        pos = child;
+    }
+}
+
+/**
+ * @brief Restores the heap after the RSSI of an entry changed.
+ */
+static void heapUpdate(network_table_t *t, int i)
+{
+    siftUp(t, t->heapPos[i]);
+    siftDown(t, t->heapPos[i]);
+}
+
+/**
+ * @brief Takes a network out of the display order.
+ */
+static void orderRemove(network_table_t *t, int i)
+{
+    int r = t->rankOf[i];
+
+    t->orderLength--;
+    memmove(&t->order[r], &t->order[r + 1], (t->orderLength - r) * sizeof(t->order[0]));
+    for (int k = r; k < t->orderLength; k++)
+    {
+        t->rankOf[t->order[k]] = k;
+    }
+}
+
+/**
+ * @brief Inserts a network into the display order according to its RSSI.
+ */
+static void orderInsert(network_table_t *t, int i)
+{
+    // Busca binária pela primeira rede mais fraca; empates mantêm a ordem de chegada
+    int lo = 0;
+    int hi = t->orderLength;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (t->networks[t->order[mid]].rssi >= t->networks[i].rssi)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    memmove(&t->order[lo + 1], &t->order[lo], (t->orderLength - lo) * sizeof(t->order[0]));
+    t->order[lo] = i;
+    t->orderLength++;
+    for (int k = lo; k < t->orderLength; k++)
+    {
+        t->rankOf[t->order[k]] = k;
+    }
+}
+
+/**
+ * @brief Received power of an RSSI, in mW.
+ */
+static float rssiToMw(int rssi)
+{
+    return powf(10.0f, rssi / 10.0f);
+}
+
+/**
+ * @brief Counts a network in the aggregate of its channel.
+ */
+static void channelAdd(network_table_t *t, const wifi_network_t *network)
+{
+    if (network->channel < 1 || network->channel > CHANNEL_COUNT)
+    {
+        return;
+    }
+
+    channel_stats_t *c = &t->channels[network->channel];
+    c->count++;
+    c->powerMw += rssiToMw(network->rssi);
+    if (network->rssi > c->strongest)
+    {
+        c->strongest = network->rssi;
+    }
+}
+
+/**
+ * @brief Takes the network at position i out of the aggregate of its channel.
+ */
+static void channelRemove(network_table_t *t, int i)
+{
+    const wifi_network_t *network = &t->networks[i];
+    if (network->channel < 1 || network->channel > CHANNEL_COUNT)
+    {
+        return;
+    }
+
+    channel_stats_t *c = &t->channels[network->channel];
+    c->count--;
+    c->powerMw -= rssiToMw(network->rssi);
+    if (c->count == 0 || c->powerMw < 0)
+    {
+        c->powerMw = 0; // Evita acumular erro de arredondamento
+    }
+
+    // Só quando sai a rede mais forte é preciso procurar a próxima no mesmo canal
+    if (network->rssi >= c->strongest)
+    {
+        c->strongest = INT8_MIN;
+        for (int k = 0; k < t->count; k++)
+        {
+            const wifi_network_t *other = &t->networks[k];
+            if (k != i && other->channel == network->channel && other->rssi > c->strongest)
+            {
+                c->strongest = other->rssi;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copies the percentiles shown by the UI from the statistics of an entry.
+ */
+static void updatePercentiles(wifi_network_t *network, const rssi_stats_t *stats)
+{
+    network->percentiles[0] = getRssiPercentile(stats, 10);
+    network->percentiles[1] = getRssiPercentile(stats, 50);
+    network->percentiles[2] = getRssiPercentile(stats, 90);
+}
+
+/**
+ * @brief Copies a scan record into a table entry.
+ */
+static void fillNetwork(wifi_network_t *network, scan_entry_t *entry, const scan_record_t *result)
+{
+    rssi_stats_t *stats = &entry->stats;
+
+    // Copia o SSID da rede encontrada para a estrutura
+    memcpy(network->ssid, result->ssid, result->ssid_len);
+    network->ssid[result->ssid_len] = '\0'; // Garante que a string esteja terminada
+
+    // Copia o BSSID da rede encontrada para a estrutura
+    memcpy(network->bssid, result->bssid, sizeof(network->bssid));
+
+    // Armazena a intensidade do sinal (RSSI) da rede encontrada e inicia o histórico
+    initRssiStats(stats, result->rssi, result->timeMs);
+    network->rssi = getSmoothedRssi(stats);
+    updatePercentiles(network, stats);
+
+    // Armazena o modo de autenticação da rede encontrada
+    network->auth_mode = result->auth_mode;
+    network->channel = result->channel;
+
+    entry->lastSeenScan = scanGeneration;
+    entry->sweepRssi = network->rssi;
+}
+
+/**
+ * @brief Records the BSSID of an entry that is leaving the table.
+ */
+static void logRemoved(network_table_t *t, int i)
+{
+    removed_log_t *log = &t->removed;
+    memcpy(log->bssids[log->total % REMOVED_LOG_SIZE], t->networks[i].bssid, sizeof(log->bssids[0]));
+    log->total++;
+}
+
+/**
+ * @brief Removes an entry of the working table, moving the last entry into its place.
+ */
+static void removeNetwork(network_table_t *t, int i)
+{
+    int last = t->count - 1;
+
+    logRemoved(t, i);
+    channelRemove(t, i);
+    orderRemove(t, i);
+    removeFromIndex(t, findSlot(t, t->networks[i].bssid));
+
+    // Retira a entrada do heap trocando-a com a última posição
+    int pos = t->heapPos[i];
+    heapSwap(t, pos, last);
+    t->count--;
+    if (pos < t->count)
+    {
+        heapUpdate(t, t->heap[pos]);
+    }
+
+    if (i != last)
+    {
+        t->networks[i] = t->networks[last];
+        scanEntries[i] = scanEntries[last];
+        t->index[findSlot(t, t->networks[i].bssid)] = i;
+        t->heap[t->heapPos[last]] = i;
+        t->heapPos[i] = t->heapPos[last];
+        t->order[t->rankOf[last]] = i;
+        t->rankOf[i] = t->rankOf[last];
+    }
+}
+
+/**
+ * @brief Empties the channel aggregates of a table or snapshot.
+ */
+static void clearChannels(channel_stats_t *channels)
+{
+    for (int c = 0; c <= CHANNEL_COUNT; c++)
+    {
+        channels[c].count = 0;
+        channels[c].strongest = INT8_MIN;
+        channels[c].powerMw = 0;
+    }
+}
+
+void clearNetworks()
+{
+    if (snapshotLock == NULL)
+    {
+        snapshotLock = spin_lock_instance(spin_lock_claim_unused(true));
+    }
+
+    memset(scan.index, 0xff, sizeof(scan.index));
+    scan.count = 0;
+    scan.orderLength = 0;
+    clearChannels(scan.channels);
+    scan.removed.total += REMOVED_LOG_SIZE + 1; // Mais remoções que o registro guarda: todas as linhas em cache caem
+    for (int i = 0; i < 3; i++)
+    {
+        snapshots[i].count = 0;
+        clearChannels(snapshots[i].channels);
+    }
+    backSlot = 0;
+    readySlot = 1;
+    readyFresh = false;
+    shownSlot = 2;
+    shown = &snapshots[shownSlot];
+    network_count = 0;
+    scanChanged = false;
+}
+
+void beginNetworkScan()
+{
+    scanGeneration++;
+    sweepAdded = 0;
+    sweepLost = 0;
+}
+
+int expireNetworks(uint32_t maxAgeScans)
+{
+    network_table_t *t = &scan;
+    int removed = 0;
+
+    for (int i = t->count - 1; i >= 0; i--)
+    {
+        if (scanGeneration - scanEntries[i].lastSeenScan >= maxAgeScans)
+        {
+            removeNetwork(t, i);
+            removed++;
+            scanChanged = true;
+        }
+    }
+
+    networksExpired += removed;
+    sweepLost += removed;
+    return removed;
+}
+
+int countSeenNetworks()
+{
+    const network_table_t *t = &scan;
+    int seen = 0;
+
+    for (int i = 0; i < t->count; i++)
+    {
+        if (scanEntries[i].lastSeenScan == scanGeneration)
+        {
+            seen++;
+        }
+    }
+    return seen;
+}
+
+void measureScanChurn(scan_churn_t *churn)
+{
+    network_table_t *t = &scan;
+
+    churn->added = sweepAdded;
+    churn->lost = sweepLost;
+    churn->rssiDeltaDb = 0;
+    for (int i = 0; i < t->count; i++)
+    {
+        scan_entry_t *entry = &scanEntries[i];
+        if (entry->lastSeenScan == scanGeneration)
+        {
+            churn->rssiDeltaDb += abs(t->networks[i].rssi - entry->sweepRssi);
+            entry->sweepRssi = t->networks[i].rssi;
+        }
+    }
+}
+
+int findNetwork(const uint8_t *bssid)
+{
+    const network_snapshot_t *s = shown;
+    for (int rank = 0; rank < s->count; rank++)
+    {
+        if (memcmp(s->networks[rank].bssid, bssid, sizeof(s->networks[rank].bssid)) == 0)
+        {
+            return rank;
+        }
+    }
+    return -1;
+}
+
+int storeScanResult(const scan_record_t *result, bool *added)
+{
+    network_table_t *t = &scan;
+    int slot = findSlot(t, result->bssid);
+    int i = t->index[slot];
+
+    *added = false;
+    if (i >= 0)
+    {
+        // Atualiza o RSSI se já estiver na lista; a ordem só muda com o valor suavizado
+        wifi_network_t *network = &t->networks[i];
+        rssi_stats_t *stats = &scanEntries[i].stats;
+        scanEntries[i].lastSeenScan = scanGeneration;
+        addRssiSample(stats, result->rssi, result->timeMs);
+        updatePercentiles(network, stats);
+
+        int rssi = getSmoothedRssi(stats);
+        if (network->rssi != rssi || network->channel != result->channel)
+        {
+            channelRemove(t, i);
+            network->channel = result->channel;
+            if (network->rssi != rssi)
+            {
+                orderRemove(t, i);
+                network->rssi = rssi;
+                heapUpdate(t, i);
+                orderInsert(t, i);
+            }
+            channelAdd(t, network);
+        }
+        scanChanged = true;
+        return i;
+    }
+
+    if (t->count < MAX_RESULTS)
+    {
+        i = t->count++; // Incrementa o contador de redes encontradas
+        fillNetwork(&t->networks[i], &scanEntries[i], result);
+        t->index[slot] = i;
+        t->heap[i] = i;
+        t->heapPos[i] = i;
+        siftUp(t, i);
+        orderInsert(t, i);
+        channelAdd(t, &t->networks[i]);
+    }
+    else if (result->rssi > t->networks[t->heap[0]].rssi)
+    {
+        // Tabela cheia: a rede mais fraca dá lugar à nova
+        i = t->heap[0];
+        logRemoved(t, i);
+        channelRemove(t, i);
+        orderRemove(t, i);
+        removeFromIndex(t, findSlot(t, t->networks[i].bssid));
+        fillNetwork(&t->networks[i], &scanEntries[i], result);
+        t->index[findSlot(t, result->bssid)] = i;
+        siftDown(t, 0);
+        orderInsert(t, i);
+        channelAdd(t, &t->networks[i]);
+        networksEvicted++;
+        sweepLost++;
+    }
+    else
+    {
+        networksDropped++;
+        return -1;
+    }
+
+    *added = true;
+    sweepAdded++;
+    scanChanged = true;
+    return i;
+}
+
+bool publishNetworks()
+{
+    if (!scanChanged)
+    {
+        return false;
+    }
+
+    // Copia as redes já na ordem de exibição para o snapshot livre e o troca pelo snapshot pronto
+    network_snapshot_t *back = &snapshots[backSlot];
+    for (int r = 0; r < scan.orderLength; r++)
+    {
+        back->networks[r] = scan.networks[scan.order[r]];
+    }
+    back->count = scan.orderLength;
+    memcpy(back->channels, scan.channels, sizeof(back->channels));
+    back->removed = scan.removed;
+    scanChanged = false;
+
+    uint32_t irq = spin_lock_blocking(snapshotLock);
+    int slot = readySlot;
+    readySlot = backSlot;
+    backSlot = slot;
+    readyFresh = true;
+    spin_unlock(snapshotLock, irq);
+    return true;
+}
+
+bool acquireNetworks()
+{
+    bool fresh;
+
+    uint32_t irq = spin_lock_blocking(snapshotLock);
+    fresh = readyFresh;
+    if (fresh)
+    {
+        int slot = shownSlot;
+        shownSlot = readySlot;
+        readySlot = slot;
+        readyFresh = false;
+    }
+    spin_unlock(snapshotLock, irq);
+
+    if (fresh)
+    {
+        shown = &snapshots[shownSlot];
+        network_count = shown->count;
+    }
+    return fresh;
+}
+
+void printNetworkReport()
+{
+    const network_table_t *t = &scan;
+
+    printf("%-32s %-17s %3s %5s %4s %4s %4s %4s %4s %5s %7s\n",
+           "SSID", "BSSID", "CH", "RSSI", "MIN", "P10", "P50", "P90", "MAX", "DP", "AMOSTRAS");
+    for (int r = 0; r < t->orderLength; r++)
+    {
+        const wifi_network_t *network = &t->networks[t->order[r]];
+        const rssi_stats_t *stats = &scanEntries[t->order[r]].stats;
+        const uint8_t *b = network->bssid;
+
+        printf("%-32s %02x:%02x:%02x:%02x:%02x:%02x %3u %5d %4d %4d %4d %4d %4d %5.1f %7lu\n",
+               network->ssid, b[0], b[1], b[2], b[3], b[4], b[5], network->channel, network->rssi, stats->min,
+               getRssiPercentile(stats, 10), getRssiPercentile(stats, 50), getRssiPercentile(stats, 90),
+               stats->max, sqrtf(getRssiVariance(stats)), (unsigned long)stats->samples);
+    }
+}
+
+const removed_log_t *getRemovedNetworks()
+{
+    return &shown->removed;
+}
+
+const channel_stats_t *getChannelStats(int channel)
+{
+    return &shown->channels[channel];
+}
+
+wifi_network_t *getRankedNetwork(int rank)
+{
+    return &shown->networks[rank];
+}
@@ -0,0 +1,198 @@
+/**
+ * @file network_store.h
+ * @brief Header file for the scanned network table.
+ *
+ * Holds the strongest networks found by the scan together with an
+ * open-addressing hash index on the BSSID, so duplicate scan results are
+ * found in O(1), a min-heap on RSSI, so the weakest entry can be evicted
+ * when a stronger network shows up in a full table, and the display order
+ * (strongest first), maintained as results arrive. Per-channel aggregates
+ * (AP count, strongest RSSI, summed power) follow every change to the table.
+ *
+ * The RSSI statistics of each network (history ring, histogram) live in an
+ * array beside the working table and never go into the snapshots; each
+ * entry carries only its P10/P50/P90, refreshed with every sample.
+ *
+ * A snapshot holds only what the UI draws: the entries already in display
+ * order, the channel aggregates and the removal log. The index, heap and
+ * order arrays stay in the working table.
+ *
+ * Scan results go into a working table owned by the scan pipeline; the
+ * lookups below read the snapshot taken by the UI with acquireNetworks().
+ */
+
+#ifndef NETWORK_STORE_H
+#define NETWORK_STORE_H
+
+#include "patro_wifi_scanner.h"
+#include "scan_ring.h"
+
+/**
+ * @brief Capacity of the network table (the K strongest networks are kept).
+ *
+ * Each network takes 48 bytes in the working table and in each of the
+ * three snapshots, plus about 150 bytes of index, heap, order and RSSI
+ * statistics on the scan side: ~340 bytes in all, so K = 384 uses ~128 KB
+ * of the 264 KB of SRAM.
+ */
+#ifndef MAX_RESULTS
+#define MAX_RESULTS 20
+#endif
+
+/** @brief Number of scans a network may be missing before it is removed. */
+#ifndef NETWORK_MAX_AGE_SCANS
+#define NETWORK_MAX_AGE_SCANS 3
+#endif
+
+/** @brief log2 of the number of hash index slots, kept at least twice MAX_RESULTS. */
+#ifndef NETWORK_INDEX_BITS
+#if MAX_RESULTS <= 32
+#define NETWORK_INDEX_BITS 6
+#elif MAX_RESULTS <= 64
+#define NETWORK_INDEX_BITS 7
+#elif MAX_RESULTS <= 128
+#define NETWORK_INDEX_BITS 8
+#elif MAX_RESULTS <= 256
+#define NETWORK_INDEX_BITS 9
+#else
+#define NETWORK_INDEX_BITS 10
+#endif
+#endif
+
+/** @brief Highest 2.4 GHz channel with aggregates; other channels are not aggregated. */
+#define CHANNEL_COUNT 14
+
+/** @brief Aggregate of the networks seen on one channel. */
+typedef struct {
+    uint16_t count;   // Redes no canal
+    int8_t strongest; // Maior RSSI suavizado no canal, INT8_MIN se vazio
+    float powerMw;    // Soma das potências recebidas, em mW
+} channel_stats_t;
+
+/** @brief Number of removed networks remembered for the row cache. */
+#ifndef REMOVED_LOG_SIZE
+#define REMOVED_LOG_SIZE 16
+#endif
+
+/**
+ * @brief BSSIDs of the networks removed most recently.
+ *
+ * The removal number n goes into bssids[n % REMOVED_LOG_SIZE]; a reader
+ * that last saw total t has missed removals when total - t exceeds
+ * REMOVED_LOG_SIZE.
+ */
+typedef struct {
+    uint32_t total; // Remoções desde o início
+    uint8_t bssids[REMOVED_LOG_SIZE][6];
+} removed_log_t;
+
+/** @brief Changes measured between two consecutive scans. */
+typedef struct {
+    uint16_t added;       // Redes novas
+    uint16_t lost;        // Redes expiradas ou substituídas
+    uint32_t rssiDeltaDb; // Soma das variações do RSSI suavizado das redes vistas
+} scan_churn_t;
+
+/** @brief Number of hash index slots. */
+#define NETWORK_INDEX_SIZE (1 << NETWORK_INDEX_BITS)
+
+_Static_assert(MAX_RESULTS <= 384, "MAX_RESULTS too large: the table and its snapshots must fit in SRAM");
+_Static_assert(NETWORK_INDEX_SIZE >= 2 * MAX_RESULTS, "NETWORK_INDEX_BITS too small for MAX_RESULTS");
+
+/** @brief Scan results discarded because the table was full of stronger networks. */
+extern uint32_t networksDropped;
+/** @brief Networks removed to make room for a stronger one. */
+extern uint32_t networksEvicted;
+/** @brief Networks removed because they were not seen for NETWORK_MAX_AGE_SCANS scans. */
+extern uint32_t networksExpired;
+
+/** @brief Empties the working table and the snapshots. */
+void clearNetworks();
+
+/** @brief Starts a new scan generation; results stored from now on count as seen. */
+void beginNetworkScan();
+
+/**
+ * @brief Removes networks that were not seen in the last scans.
+ *
+ * @param maxAgeScans Number of finished scans a network may be missing.
+ * @return Number of networks removed.
+ */
+int expireNetworks(uint32_t maxAgeScans);
+
+/** @brief Returns the number of networks of the working table seen in the current scan. */
+int countSeenNetworks();
+
+/**
+ * @brief Measures the changes of the scan ending, since the previous one.
+ *
+ * Call after expireNetworks(); the RSSI of the networks seen becomes the
+ * reference of the next measurement.
+ *
+ * @param churn Receives the measurement.
+ */
+void measureScanChurn(scan_churn_t *churn);
+
+/**
+ * @brief Looks up a network of the UI snapshot by BSSID.
+ *
+ * Searches the snapshot linearly; the UI calls it once per snapshot to
+ * follow the selection.
+ *
+ * @param bssid BSSID to look for.
+ * @return Position in the display order, or -1 if not present.
+ */
+int findNetwork(const uint8_t *bssid);
+
+/**
+ * @brief Adds a scan result or refreshes the entry with the same BSSID.
+ *
+ * When the table is full, the weakest network is evicted if the result is
+ * stronger, otherwise the result is dropped.
+ *
+ * @param result Scan record taken from the scan ring.
+ * @param added Set to true when a new entry was created.
+ * @return Index of the entry in the working table, or -1 if the result was dropped.
+ */
+int storeScanResult(const scan_record_t *result, bool *added);
+
+/**
+ * @brief Publishes a snapshot of the working table (scan pipeline side).
+ *
+ * Must not run concurrently with storeScanResult() or expireNetworks().
+ *
+ * @return true if the table changed since the last snapshot.
+ */
+bool publishNetworks();
+
+/**
+ * @brief Takes the newest published snapshot and updates network_count (UI side).
+ *
+ * @return true if a new snapshot replaced the one being shown.
+ */
+bool acquireNetworks();
+
+/**
+ * @brief Returns the aggregate of a channel in the UI snapshot.
+ *
+ * @param channel Channel number, 1 to CHANNEL_COUNT.
+ */
+const channel_stats_t *getChannelStats(int channel);
+
+/** @brief Returns the networks removed or evicted up to the UI snapshot. */
+const removed_log_t *getRemovedNetworks();
+
+/**
+ * @brief Prints the networks of the working table with their RSSI
+ *        statistics and percentiles (scan pipeline side).
+ */
+void printNetworkReport();
+
+/**
+ * @brief Returns the network at a position of the display order.
+ *
+ * @param rank 0 for the strongest network, up to network_count - 1.
+ */
+wifi_network_t *getRankedNetwork(int rank);
+
+#endif // NETWORK_STORE_H
@@ -0,0 +1,112 @@
+/**
+ * @file network_store_bench.c
+ * @brief Host benchmark of the BSSID hash index against a linear search.
+ *
+ * Feeds 1k to 10k synthetic scan results from a population of access
+ * points four times larger than the table into storeScanResult(), then
+ * looks every BSSID up both through the hash index and with the linear
+ * memcmp search the table used before. Both lookups must agree; the time
+ * per result of each is reported.
+ *
+ * Build and run with libs/host/run_tests.sh.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_RESULTS 384
+#include "network_store.c"
+
+int network_count = 0;
+
+/** @brief Distinct access points the results are drawn from. */
+#define POPULATION (4 * MAX_RESULTS)
+
+/**
+ * @brief The lookup before the hash index: compares every stored BSSID.
+ */
+static int findLinear(const network_table_t *t, const uint8_t *bssid)
+{
+    for (int i = 0; i < t->count; i++)
+    {
+        if (memcmp(t->networks[i].bssid, bssid, sizeof(t->networks[i].bssid)) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void makeResult(scan_record_t *record, int ap)
+{
+    memset(record, 0, sizeof(*record));
+    record->bssid[0] = 0x02;
+    record->bssid[3] = ap >> 16;
+    record->bssid[4] = ap >> 8;
+    record->bssid[5] = ap;
+    record->ssid_len = snprintf((char *)record->ssid, sizeof(record->ssid), "ap%d", ap);
+    record->channel = 1 + ap % 13;
+    record->rssi = -30 - (ap * 7 + rand() % 9) % 65; // Cada AP oscila perto do seu próprio nível
+}
+
+static double elapsedNs(absolute_time_t start, int count)
+{
+    return absolute_time_diff_us(start, get_absolute_time()) * 1000.0 / count;
+}
+
+int main(void)
+{
+    static const int sizes[] = {1000, 2000, 5000, 10000};
+    static scan_record_t results[10000];
+    volatile int sink = 0;
+    srand(10);
+
+    printf("%7s %10s %12s %12s %8s\n", "results", "store ns", "hash ns", "linear ns", "kept");
+    for (size_t s = 0; s < count_of(sizes); s++)
+    {
+        int n = sizes[s];
+        for (int i = 0; i < n; i++)
+        {
+            makeResult(&results[i], rand() % POPULATION);
+        }
+
+        clearNetworks();
+        beginNetworkScan();
+        absolute_time_t start = get_absolute_time();
+        for (int i = 0; i < n; i++)
+        {
+            bool added;
+            storeScanResult(&results[i], &added);
+        }
+        double storeNs = elapsedNs(start, n);
+
+        // Confere a tabela final contra a busca linear antes de medir
+        for (int i = 0; i < n; i++)
+        {
+            if (scan.index[findSlot(&scan, results[i].bssid)] != findLinear(&scan, results[i].bssid))
+            {
+                printf("FAIL lookup %d of %d differs\n", i, n);
+                return 1;
+            }
+        }
+
+        start = get_absolute_time();
+        for (int i = 0; i < n; i++)
+        {
+            sink += scan.index[findSlot(&scan, results[i].bssid)];
+        }
+        double hashNs = elapsedNs(start, n);
+
+        start = get_absolute_time();
+        for (int i = 0; i < n; i++)
+        {
+            sink += findLinear(&scan, results[i].bssid);
+        }
+        double linearNs = elapsedNs(start, n);
+
+        printf("%7d %10.0f %12.1f %12.1f %8d\n", n, storeNs, hashNs, linearNs, scan.count);
+    }
+
+    printf("OK: K=%d, hash and linear lookups agree\n", MAX_RESULTS);
+    return 0;
+}
@@ -2,10 +2,23 @@
 
 int selectedOption = 0;
 int network_count = 0;
-int inputCooldown = 0;
+
+// Função para converter RSSI em barras de sinal (1 a 5)
+int rssiToBars(int rssi) {
+    if (rssi >= -50) return 5; // Excelente sinal
+    if (rssi >= -60) return 4; // Bom sinal
+    if (rssi >= -70) return 3; // Sinal razoável
+    if (rssi >= -80) return 2; // Sinal fraco
+    return 1; // Sem sinal
+}
 
 // Função para desenhar barras de sinal no display
 void drawSignalBars(int x, int y, int bars) {
+    renderSignalBars(&display, x, y, bars);
+}
+
+// Desenha as barras de sinal em qualquer buffer (display ou canvas)
+void renderSignalBars(ssd1306_t *target, int x, int y, int bars) {
     int barWidth = 2;
     int barSpacing = 1;
     int barHeightUnit = 2;
@@ -15,12 +28,18 @@ void drawSignalBars(int x, int y, int bars) {
         if (height > 0) {
             int barX = x + i * (barWidth + barSpacing);
             int barY = y + (TEXT_HEIGHT - height);
-            drawRectangle(barX, barY, barWidth, height);
+            ssd1306_draw_square(target, barX, barY, barWidth, height);
         }
     }
 }
 
 void drawAppHeader() {
+    char header[64];
+    snprintf(header, sizeof(header), "Networks found (%d)", network_count);
+    drawAppHeaderWithSubtitle(header);
+}
+
+void drawAppHeaderWithSubtitle(char *subtitle) {
     drawClearRectangle(0, 0, SCREEN_WIDTH, 16); // Limpa a área do cabeçalho
 
     // Título:
@@ -29,8 +48,6 @@ void drawAppHeader() {
     y += TEXT_HEIGHT; 
 
     // Header:
-    char header[64];
-    snprintf(header, sizeof(header), "Networks found (%d)", network_count);
-    drawTextCentered(header, y);
+    drawTextCentered(subtitle, y);
     drawLine(0, 16, SCREEN_WIDTH, 16);
 }
\ No newline at end of file
@@ -3,15 +3,27 @@
 #include "text.h"
 #include "draw.h"
 
+// Estrutura para armazenar informações de redes Wi-Fi
+typedef struct {
+    char ssid[33];      // SSID da rede Wi-Fi (32 caracteres + '\0')
+    uint8_t bssid[6];   // Endereço MAC da rede (BSSID)
+    uint8_t channel;    // Canal em que a rede foi vista
+    int8_t rssi;        // Intensidade do sinal (RSSI), suavizada; usada na ordenação e nas barras
+    int8_t percentiles[3]; // P10, P50 e P90 do RSSI, copiados das estatísticas da varredura
+    uint32_t auth_mode;  // Modo de autenticação (WPA, WPA2, etc.)
+    
+} wifi_network_t;
+
 // Contador de redes encontradas
 extern int network_count;
 // Opção selecionada no menu
 extern int selectedOption;
-// Cooldown para evitar múltiplas leituras rápidas
-extern int inputCooldown;
 
+int rssiToBars(int rssi);
 void drawSignalBars(int x, int y, int bars);
+void renderSignalBars(ssd1306_t *target, int x, int y, int bars);
 void drawAppHeader();
+void drawAppHeaderWithSubtitle(char *subtitle);
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+/**
+ * @file row_cache.c
+ * @brief Implementation for the network list row cache.
+ *
+ * Each slot holds a row rendered on an off-screen canvas, keyed by BSSID,
+ * signal bars and selection state. A frame only blits the visible rows;
+ * text rasterization happens when a row is first shown or its data changes.
+ */
+
+#include "row_cache.h"
+#include <string.h>
+
+uint32_t rowCacheHits = 0;
+uint32_t rowCacheMisses = 0;
+
+typedef struct {
+    uint8_t bssid[6];
+    int8_t bars;
+    bool selected;
+    bool valid;
+    uint32_t lastUse;
+    uint16_t cols[SCREEN_WIDTH];
+} row_cache_slot_t;
+
+static row_cache_slot_t slots[ROW_CACHE_SLOTS];
+static uint32_t useClock = 0;
+
+/** @brief Off-screen canvas, two pages high. */
+static ssd1306_t canvas;
+/** @brief Pre-rendered selection cursor. */
+static uint16_t cursorCols[TEXT_WIDTH];
+
+/**
+ * @brief Copies the first two pages of the canvas into column words.
+ */
+static void readCanvas(uint16_t *cols, int width)
+{
+    for (int x = 0; x < width; x++)
+    {
+        cols[x] = canvas.buffer[x] | (canvas.buffer[SCREEN_WIDTH + x] << 8);
+    }
+}
+
+/**
+ * @brief Renders a row the same way the list used to draw it directly.
+ */
+static void renderRow(row_cache_slot_t *slot, const row_content_t *content, bool selected)
+{
+    ssd1306_clear(&canvas);
+
+    // A linha do texto fica uma linha abaixo do topo, para caber a barra de seleção
+    int y = 1;
+    ssd1306_draw_string(&canvas, selected ? 8 : 0, y, 1, content->ssid);
+
+    int _rssi_x = SCREEN_WIDTH - 20;
+    ssd1306_clear_square(&canvas, _rssi_x - 2, y, 50, TEXT_HEIGHT);
+    renderSignalBars(&canvas, _rssi_x, y, content->bars);
+
+    if (selected)
+    {
+        ssd1306_invert_square(&canvas, 0, 0, SCREEN_WIDTH, TEXT_HEIGHT + 1);
+    }
+
+    readCanvas(slot->cols, SCREEN_WIDTH);
+}
+
+void initRowCache()
+{
+    if (!ssd1306_init_canvas(&canvas, SCREEN_WIDTH, 16))
+    {
+        printf("Falha ao alocar o canvas das linhas\n");
+        return;
+    }
+
+    ssd1306_clear(&canvas);
+    ssd1306_draw_char(&canvas, 0, 1, 1, '>');
+    readCanvas(cursorCols, TEXT_WIDTH);
+
+    clearRowCache();
+}
+
+void setRowContent(row_content_t *content, const wifi_network_t *network)
+{
+    memcpy(content->ssid, network->ssid, sizeof(content->ssid));
+    memcpy(content->bssid, network->bssid, sizeof(content->bssid));
+    content->bars = rssiToBars(network->rssi);
+}
+
+const uint16_t *getRowBitmap(const row_content_t *content, bool selected)
+{
+    int8_t bars = content->bars;
+    row_cache_slot_t *victim = &slots[0];
+
+    useClock++;
+    for (int i = 0; i < ROW_CACHE_SLOTS; i++)
+    {
+        row_cache_slot_t *slot = &slots[i];
+        if (slot->valid && slot->bars == bars && slot->selected == selected &&
+            memcmp(slot->bssid, content->bssid, sizeof(slot->bssid)) == 0)
+        {
+            slot->lastUse = useClock;
+            rowCacheHits++;
+            return slot->cols;
+        }
+
+        // Substitui uma entrada vazia ou a usada há mais tempo
+        if (victim->valid && (!slot->valid || slot->lastUse < victim->lastUse))
+        {
+            victim = slot;
+        }
+    }
+
+    rowCacheMisses++;
+    memcpy(victim->bssid, content->bssid, sizeof(victim->bssid));
+    victim->bars = bars;
+    victim->selected = selected;
+    victim->valid = true;
+    victim->lastUse = useClock;
+    renderRow(victim, content, selected);
+    return victim->cols;
+}
+
+void invalidateRow(const uint8_t *bssid)
+{
+    for (int i = 0; i < ROW_CACHE_SLOTS; i++)
+    {
+        if (slots[i].valid && memcmp(slots[i].bssid, bssid, sizeof(slots[i].bssid)) == 0)
+        {
+            slots[i].valid = false;
+        }
+    }
+}
+
+void invalidateRemovedRows(const removed_log_t *log)
+{
+    static uint32_t seen = 0;
+
+    // Também cobre o total menor que o visto (volta de 32 bits)
+    if (log->total - seen > REMOVED_LOG_SIZE)
+    {
+        clearRowCache();
+    }
+    else
+    {
+        for (uint32_t n = seen; n != log->total; n++)
+        {
+            invalidateRow(log->bssids[n % REMOVED_LOG_SIZE]);
+        }
+    }
+    seen = log->total;
+}
+
+void clearRowCache()
+{
+    for (int i = 0; i < ROW_CACHE_SLOTS; i++)
+    {
+        slots[i].valid = false;
+    }
+}
+
+void drawNetworkRow(const row_content_t *content, int y, bool selected)
+{
+    const uint16_t *cols = getRowBitmap(content, selected);
+    ssd1306_blit(&display, 0, y - 1, cols, SCREEN_WIDTH, ROW_BITMAP_HEIGHT, SSD1306_ROP_SET);
+}
+
+void drawRowCursor(int x, int y)
+{
+    ssd1306_blit(&display, x, y - 1, cursorCols, TEXT_WIDTH, ROW_BITMAP_HEIGHT, SSD1306_ROP_XOR);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file row_cache.h
+ * @brief Header file for the network list row cache.
+ *
+ * Rows of the network list are rendered once into column bitmaps and
+ * blitted on the following frames until their content changes.
+ *
+ * A row is keyed by BSSID, signal bars and selection; the SSID of a BSSID
+ * only changes when the network leaves the table and comes back, so the
+ * rows of removed networks are dropped through the removal log of the
+ * network table.
+ */
+
+#ifndef ROW_CACHE_H
+#define ROW_CACHE_H
+
+#include "patro_wifi_scanner.h"
+#include "network_store.h"
+
+/** @brief Number of rendered rows kept in the cache. */
+#define ROW_CACHE_SLOTS 8
+/** @brief Height of a cached row: the text plus one line above it for the selection bar. */
+#define ROW_BITMAP_HEIGHT (TEXT_HEIGHT + 1)
+
+/** @brief What a network row shows. */
+typedef struct {
+    char ssid[33];
+    uint8_t bssid[6]; // Chave do cache
+    int8_t bars;
+} row_content_t;
+
+/** @brief Rows served from the cache. */
+extern uint32_t rowCacheHits;
+/** @brief Rows that had to be rendered. */
+extern uint32_t rowCacheMisses;
+
+/** @brief Allocates the canvas used to render rows. */
+void initRowCache();
+
+/**
+ * @brief Fills the content of a row from a network.
+ */
+void setRowContent(row_content_t *content, const wifi_network_t *network);
+
+/**
+ * @brief Returns the rendered bitmap of a network row.
+ *
+ * @param content Content of the row.
+ * @param selected Whether the row is highlighted.
+ * @return SCREEN_WIDTH columns of ROW_BITMAP_HEIGHT pixels, valid until the next call.
+ */
+const uint16_t *getRowBitmap(const row_content_t *content, bool selected);
+
+/**
+ * @brief Drops every cached row of a network, e.g. after its scan data changed.
+ *
+ * @param bssid BSSID of the network.
+ */
+void invalidateRow(const uint8_t *bssid);
+
+/**
+ * @brief Drops the cached rows of the networks removed since the last call.
+ *
+ * Drops every row if more networks were removed than the log remembers.
+ *
+ * @param log Removal log of the networks being drawn.
+ */
+void invalidateRemovedRows(const removed_log_t *log);
+
+/** @brief Drops all cached rows. */
+void clearRowCache();
+
+/**
+ * @brief Draws a network row on the display.
+ *
+ * @param content Content of the row.
+ * @param y Y-coordinate of the text, the selection bar starts one line above.
+ * @param selected Whether the row is highlighted.
+ */
+void drawNetworkRow(const row_content_t *content, int y, bool selected);
+
+/**
+ * @brief Draws the selection cursor inverted over the selection bar.
+ *
+ * @param x X-coordinate of the cursor.
+ * @param y Y-coordinate of the text of the selected row.
+ */
+void drawRowCursor(int x, int y);
+
+#endif // ROW_CACHE_H
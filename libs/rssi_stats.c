@@ -0,0 +1,137 @@
+/**
+ * @file rssi_stats.c
+ * @brief Implementation for the per-network RSSI statistics.
+ */
+
+#include "rssi_stats.h"
+#include <string.h>
+
+/**
+ * @brief Clamps a value to the int8_t range of the history.
+ */
+static int8_t clampRssi(int rssi)
+{
+    return rssi < INT8_MIN ? INT8_MIN : rssi > INT8_MAX ? INT8_MAX : rssi;
+}
+
+/**
+ * @brief Counts a sample in the histogram.
+ *
+ * When a bin is about to overflow, every bin is halved: the shape of the
+ * distribution is kept and older samples weigh a little less.
+ */
+static void addToHistogram(rssi_stats_t *stats, int8_t sample)
+{
+    int bin = (sample - RSSI_HIST_MIN_DBM) / RSSI_HIST_BIN_DB;
+    if (bin < 0) bin = 0;
+    if (bin >= RSSI_HIST_BINS) bin = RSSI_HIST_BINS - 1;
+
+    if (stats->histogram[bin] == UINT16_MAX)
+    {
+        for (int i = 0; i < RSSI_HIST_BINS; i++)
+        {
+            stats->histogram[i] = (stats->histogram[i] + 1) / 2;
+        }
+    }
+    stats->histogram[bin]++;
+}
+
+void initRssiStats(rssi_stats_t *stats, int rssi, uint32_t timeMs)
+{
+    stats->historyHead = 0;
+    stats->historyCount = 0;
+    stats->min = clampRssi(rssi);
+    stats->max = clampRssi(rssi);
+    stats->smoothedQ4 = rssi * 16;
+    stats->samples = 0;
+    stats->mean = 0;
+    stats->m2 = 0;
+    memset(stats->histogram, 0, sizeof(stats->histogram));
+    addRssiSample(stats, rssi, timeMs);
+}
+
+void addRssiSample(rssi_stats_t *stats, int rssi, uint32_t timeMs)
+{
+    int8_t sample = clampRssi(rssi);
+
+    // Anel com as últimas amostras
+    stats->history[stats->historyHead] = sample;
+    stats->historyTime[stats->historyHead] = timeMs / RSSI_TIME_UNIT_MS;
+    stats->historyHead = (stats->historyHead + 1) % RSSI_HISTORY_LEN;
+    if (stats->historyCount < RSSI_HISTORY_LEN)
+    {
+        stats->historyCount++;
+    }
+
+    if (sample < stats->min) stats->min = sample;
+    if (sample > stats->max) stats->max = sample;
+
+    // Média móvel exponencial em ponto fixo
+    stats->smoothedQ4 += (sample * 16 - stats->smoothedQ4) / (1 << RSSI_EWMA_SHIFT);
+
+    // Média e variância pelo método de Welford, estável para muitas amostras
+    stats->samples++;
+    float delta = sample - stats->mean;
+    stats->mean += delta / stats->samples;
+    stats->m2 += delta * (sample - stats->mean);
+
+    addToHistogram(stats, sample);
+}
+
+int getSmoothedRssi(const rssi_stats_t *stats)
+{
+    int q4 = stats->smoothedQ4;
+    return (q4 >= 0 ? q4 + 8 : q4 - 8) / 16;
+}
+
+float getRssiVariance(const rssi_stats_t *stats)
+{
+    return stats->samples > 1 ? stats->m2 / (stats->samples - 1) : 0;
+}
+
+int getRssiPercentile(const rssi_stats_t *stats, int percent)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < RSSI_HIST_BINS; i++)
+    {
+        total += stats->histogram[i];
+    }
+    if (total == 0)
+    {
+        return getSmoothedRssi(stats);
+    }
+
+    // Procura a faixa onde a contagem acumulada passa do percentil e interpola dentro dela
+    uint32_t target = total * percent;
+    uint32_t below = 0;
+    int bin = 0;
+    while (bin < RSSI_HIST_BINS - 1 && (below + stats->histogram[bin]) * 100 < target)
+    {
+        below += stats->histogram[bin];
+        bin++;
+    }
+
+    int low = RSSI_HIST_MIN_DBM + bin * RSSI_HIST_BIN_DB;
+    uint32_t count = stats->histogram[bin];
+    int value = low;
+    if (count > 0 && target > below * 100)
+    {
+        value += (int)((target - below * 100) * RSSI_HIST_BIN_DB / (count * 100));
+    }
+
+    // Os extremos do histograma são abertos; min e max limitam a estimativa
+    if (value < stats->min) value = stats->min;
+    if (value > stats->max) value = stats->max;
+    return value;
+}
+
+int getRssiHistory(const rssi_stats_t *stats, int age, uint32_t *timeMs)
+{
+    int pos = (stats->historyHead + RSSI_HISTORY_LEN - 1 - age) % RSSI_HISTORY_LEN;
+
+    if (timeMs != NULL)
+    {
+        *timeMs = (uint32_t)stats->historyTime[pos] * RSSI_TIME_UNIT_MS;
+    }
+    return stats->history[pos];
+}
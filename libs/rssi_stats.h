@@ -0,0 +1,99 @@
+/**
+ * @file rssi_stats.h
+ * @brief Header file for the per-network RSSI statistics.
+ *
+ * Each network keeps its last samples in a small ring, an exponentially
+ * weighted moving average used for sorting and the signal bars, and
+ * running min/max/mean/variance (Welford), all in a fixed-size struct.
+ *
+ * Percentiles over the whole life of a network come from a histogram of
+ * fixed RSSI bins: memory stays constant however long a survey runs, and
+ * the resolution is RSSI_HIST_BIN_DB.
+ */
+
+#ifndef RSSI_STATS_H
+#define RSSI_STATS_H
+
+#include "pico/stdlib.h"
+
+/** @brief Number of samples kept in the history ring. */
+#ifndef RSSI_HISTORY_LEN
+#define RSSI_HISTORY_LEN 8
+#endif
+
+/** @brief Weight of a new sample in the average is 1 / 2^RSSI_EWMA_SHIFT. */
+#ifndef RSSI_EWMA_SHIFT
+#define RSSI_EWMA_SHIFT 2
+#endif
+
+/** @brief Resolution of the sample timestamps. */
+#define RSSI_TIME_UNIT_MS 100
+
+/** @brief Lower edge of the first histogram bin; weaker samples go into it. */
+#define RSSI_HIST_MIN_DBM -100
+/** @brief Width of a histogram bin. */
+#define RSSI_HIST_BIN_DB 2
+/** @brief Number of histogram bins; stronger samples go into the last one. */
+#define RSSI_HIST_BINS 40
+
+_Static_assert(RSSI_HISTORY_LEN <= 255, "RSSI_HISTORY_LEN must fit uint8_t");
+
+/** @brief RSSI history and statistics of one network. */
+typedef struct {
+    int8_t history[RSSI_HISTORY_LEN];      // Últimas amostras
+    uint16_t historyTime[RSSI_HISTORY_LEN]; // Instante de cada amostra, em RSSI_TIME_UNIT_MS
+    uint8_t historyHead;                   // Posição da próxima amostra
+    uint8_t historyCount;                  // Amostras válidas no anel
+    int8_t min;
+    int8_t max;
+    int16_t smoothedQ4;                    // Média móvel exponencial, em 1/16 dBm
+    uint32_t samples;                      // Amostras desde que a rede apareceu
+    float mean;
+    float m2;                              // Soma dos quadrados dos desvios (Welford)
+    uint16_t histogram[RSSI_HIST_BINS];    // Contagem de amostras por faixa de RSSI
+} rssi_stats_t;
+
+/**
+ * @brief Starts the statistics with a first sample.
+ *
+ * @param stats Statistics to initialize.
+ * @param rssi Sample in dBm.
+ * @param timeMs Time of the sample since boot.
+ */
+void initRssiStats(rssi_stats_t *stats, int rssi, uint32_t timeMs);
+
+/**
+ * @brief Adds a sample to the history and the statistics.
+ *
+ * @param stats Statistics to update.
+ * @param rssi Sample in dBm.
+ * @param timeMs Time of the sample since boot.
+ */
+void addRssiSample(rssi_stats_t *stats, int rssi, uint32_t timeMs);
+
+/** @brief Returns the smoothed RSSI, rounded to dBm. */
+int getSmoothedRssi(const rssi_stats_t *stats);
+
+/** @brief Returns the variance of the samples, in dBm². */
+float getRssiVariance(const rssi_stats_t *stats);
+
+/**
+ * @brief Estimates a percentile of all samples from the histogram.
+ *
+ * @param stats Statistics.
+ * @param percent Percentile, 0 to 100 (50 is the median).
+ * @return RSSI in dBm, interpolated inside the bin.
+ */
+int getRssiPercentile(const rssi_stats_t *stats, int percent);
+
+/**
+ * @brief Returns a sample of the history.
+ *
+ * @param stats Statistics.
+ * @param age 0 for the newest sample, up to historyCount - 1.
+ * @param timeMs If not NULL, receives the time of the sample (wraps every ~109 minutes).
+ * @return Sample in dBm.
+ */
+int getRssiHistory(const rssi_stats_t *stats, int age, uint32_t *timeMs);
+
+#endif // RSSI_STATS_H
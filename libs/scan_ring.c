@@ -0,0 +1,73 @@
+/**
+ * @file scan_ring.c
+ * @brief Implementation for the scan result ring.
+ *
+ * head and tail run freely and are masked on access, so a full ring is
+ * head - tail == SCAN_RING_SIZE and every slot can be used. The barriers
+ * order the record copy against the index update, so the consumer never
+ * sees an index before the data it covers.
+ */
+
+#include "scan_ring.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+void initScanRing(scan_ring_t *ring)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overflows = 0;
+    ring->highWater = 0;
+}
+
+bool scanRingPush(scan_ring_t *ring, const cyw43_ev_scan_result_t *result)
+{
+    uint32_t head = ring->head;
+    uint32_t used = head - ring->tail;
+
+    if (used >= SCAN_RING_SIZE)
+    {
+        ring->overflows++;
+        return false;
+    }
+
+    scan_record_t *record = &ring->records[head & (SCAN_RING_SIZE - 1)];
+    memcpy(record->bssid, result->bssid, sizeof(record->bssid));
+    record->rssi = result->rssi;
+    record->auth_mode = result->auth_mode;
+    record->channel = result->channel;
+    record->ssid_len = result->ssid_len < sizeof(record->ssid) ? result->ssid_len : sizeof(record->ssid);
+    memcpy(record->ssid, result->ssid, record->ssid_len);
+    record->timeMs = to_ms_since_boot(get_absolute_time());
+
+    // Publica o registro só depois de escrito
+    __dmb();
+    ring->head = head + 1;
+
+    if (used + 1 > ring->highWater)
+    {
+        ring->highWater = used + 1;
+    }
+    return true;
+}
+
+const scan_record_t *scanRingPeek(scan_ring_t *ring)
+{
+    uint32_t tail = ring->tail;
+
+    if (tail == ring->head)
+    {
+        return NULL;
+    }
+
+    // Lê o registro só depois de ver o índice que o cobre
+    __dmb();
+    return &ring->records[tail & (SCAN_RING_SIZE - 1)];
+}
+
+void scanRingRelease(scan_ring_t *ring)
+{
+    // Termina de ler o registro antes de devolver a posição ao produtor
+    __dmb();
+    ring->tail = ring->tail + 1;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file scan_ring.h
+ * @brief Header file for the scan result ring.
+ *
+ * Single-producer/single-consumer ring of fixed-size scan records. The
+ * cyw43 scan callback pushes records from the background IRQ and the main
+ * loop drains them, without locks: only the producer writes head and only
+ * the consumer writes tail.
+ */
+
+#ifndef SCAN_RING_H
+#define SCAN_RING_H
+
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+
+/** @brief Number of records in the ring, a power of two. */
+#ifndef SCAN_RING_SIZE
+#define SCAN_RING_SIZE 32
+#endif
+
+_Static_assert((SCAN_RING_SIZE & (SCAN_RING_SIZE - 1)) == 0, "SCAN_RING_SIZE must be a power of two");
+
+/** @brief Compact copy of the fields of a scan result the scanner uses. */
+typedef struct {
+    uint8_t bssid[6];
+    int16_t rssi;
+    uint8_t auth_mode;
+    uint8_t channel;
+    uint8_t ssid_len;
+    char ssid[32];   // Não terminado em '\0', ver ssid_len
+    uint32_t timeMs; // Instante em que o resultado chegou
+} scan_record_t;
+
+/** @brief Ring state and counters. */
+typedef struct {
+    scan_record_t records[SCAN_RING_SIZE];
+    volatile uint32_t head;      // Próxima posição a escrever (produtor)
+    volatile uint32_t tail;      // Próxima posição a ler (consumidor)
+    volatile uint32_t overflows; // Resultados descartados com o anel cheio
+    volatile uint32_t highWater; // Maior ocupação observada
+} scan_ring_t;
+
+/** @brief Empties the ring and resets its counters. Not safe while the producer runs. */
+void initScanRing(scan_ring_t *ring);
+
+/**
+ * @brief Copies a scan result into the ring (producer side).
+ *
+ * @param ring Ring.
+ * @param result Scan result from the cyw43 driver.
+ * @return false if the ring was full and the result was dropped.
+ */
+bool scanRingPush(scan_ring_t *ring, const cyw43_ev_scan_result_t *result);
+
+/**
+ * @brief Returns the oldest record without removing it (consumer side).
+ *
+ * @param ring Ring.
+ * @return The record, or NULL if the ring is empty.
+ */
+const scan_record_t *scanRingPeek(scan_ring_t *ring);
+
+/** @brief Removes the record returned by scanRingPeek (consumer side). */
+void scanRingRelease(scan_ring_t *ring);
+
+#endif // SCAN_RING_H
@@ -0,0 +1,156 @@
+/**
+ * @file scan_ring_test.c
+ * @brief Host stress test of the scan ring with a producer and a consumer thread.
+ *
+ * The producer stands in for the cyw43 scan callback and the consumer for
+ * the scan pipeline. Every record carries its sequence number in the BSSID
+ * and a pattern derived from it in the SSID and RSSI, so a record read
+ * before it was completely written, read twice or skipped is detected.
+ *
+ * The first pass retries on a full ring and must deliver every record in
+ * order; the second drops records like the scan callback does and must
+ * deliver an increasing sequence with the drops counted as overflows.
+ *
+ * Build and run with libs/host/run_tests.sh.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "scan_ring.h"
+
+/** @brief Records pushed per pass. */
+#define STRESS_RECORDS 2000000u
+
+static scan_ring_t ring;
+static bool retryWhenFull;
+static volatile bool producerDone;
+
+static void makeResult(cyw43_ev_scan_result_t *result, uint32_t seq)
+{
+    memcpy(result->bssid, &seq, sizeof(seq));
+    result->bssid[4] = ~seq;
+    result->bssid[5] = seq >> 3;
+    result->ssid_len = 1 + seq % 32;
+    for (int i = 0; i < result->ssid_len; i++)
+    {
+        result->ssid[i] = seq + i;
+    }
+    result->rssi = -(int)(seq % 100);
+    result->channel = 1 + seq % 13;
+}
+
+/**
+ * @brief Checks a record against the result it was made from.
+ *
+ * @return The sequence number, or -1 if the record is corrupted.
+ */
+static int64_t checkRecord(const scan_record_t *record)
+{
+    uint32_t seq;
+    cyw43_ev_scan_result_t expected;
+
+    memcpy(&seq, record->bssid, sizeof(seq));
+    makeResult(&expected, seq);
+    if (memcmp(record->bssid, expected.bssid, sizeof(record->bssid)) != 0 ||
+        record->ssid_len != expected.ssid_len || memcmp(record->ssid, expected.ssid, record->ssid_len) != 0 ||
+        record->rssi != expected.rssi || record->channel != expected.channel)
+    {
+        return -1;
+    }
+    return seq;
+}
+
+static void *produce(void *arg)
+{
+    cyw43_ev_scan_result_t result = {0};
+
+    for (uint32_t seq = 0; seq < STRESS_RECORDS; seq++)
+    {
+        makeResult(&result, seq);
+        if (retryWhenFull)
+        {
+            while (!scanRingPush(&ring, &result))
+            {
+                sched_yield(); // Anel cheio: espera o consumidor
+            }
+        }
+        else
+        {
+            scanRingPush(&ring, &result);
+            if (seq % 48 == 0)
+            {
+                sched_yield(); // Resultados chegam aos poucos, como do driver
+            }
+        }
+    }
+    producerDone = true;
+    return NULL;
+}
+
+/**
+ * @brief Runs one pass and checks what the consumer received.
+ *
+ * @return false on a failure.
+ */
+static bool runPass(bool retry)
+{
+    pthread_t producer;
+    uint32_t received = 0;
+    int64_t last = -1;
+
+    initScanRing(&ring);
+    retryWhenFull = retry;
+    producerDone = false;
+    pthread_create(&producer, NULL, produce, NULL);
+
+    while (true)
+    {
+        bool done = producerDone;
+        const scan_record_t *record = scanRingPeek(&ring);
+        if (record == NULL)
+        {
+            if (done)
+            {
+                break; // Produtor terminou e o anel esvaziou
+            }
+            sched_yield();
+            continue;
+        }
+
+        int64_t seq = checkRecord(record);
+        if (seq < 0 || seq <= last || (retry && seq != last + 1))
+        {
+            printf("FAIL %s: record %lld after %lld\n", retry ? "retry" : "drop", (long long)seq, (long long)last);
+            return false;
+        }
+        last = seq;
+        received++;
+        scanRingRelease(&ring);
+    }
+    pthread_join(producer, NULL);
+
+    uint32_t expected = retry ? STRESS_RECORDS : STRESS_RECORDS - ring.overflows;
+    if (received != expected || ring.highWater > SCAN_RING_SIZE)
+    {
+        printf("FAIL %s: received %u of %u, high water %u\n", retry ? "retry" : "drop",
+               (unsigned)received, (unsigned)expected, (unsigned)ring.highWater);
+        return false;
+    }
+
+    printf("%s: %u records received, %u overflows, high water %u of %u\n", retry ? "retry" : "drop",
+           (unsigned)received, (unsigned)ring.overflows, (unsigned)ring.highWater, SCAN_RING_SIZE);
+    return true;
+}
+
+int main(void)
+{
+    if (!runPass(true) || !runPass(false))
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,439 @@
+/**
+ * @file scan_task.c
+ * @brief Implementation for the Wi-Fi scan pipeline.
+ */
+
+#include "scan_task.h"
+#include "network_store.h"
+#include "wifi_connect.h"
+#include "pico/cyw43_arch.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+scan_ring_t scanRing;
+
+/** @brief Whether a scan is in progress. */
+static bool scanning = false;
+/** @brief When the next scan starts. */
+static absolute_time_t scanTime;
+/** @brief When the next partial snapshot is published. */
+static absolute_time_t liveUpdateTime;
+/** @brief When the sweep in progress started. */
+static absolute_time_t sweepStart;
+
+// O driver cyw43 só repassa ao firmware o SSID e o tipo da varredura: número
+// de sondas, tempos de permanência e lista de canais são sobrescritos. Os
+// perfis variam então o tipo, a pausa entre varreduras e a publicação parcial.
+static const scan_profile_config_t scanProfiles[SCAN_PROFILE_COUNT] = {
+    [SCAN_PROFILE_NONSTOP] = {"Nonstop", 0, 0, 2 * NETWORK_MAX_AGE_SCANS, true},
+    [SCAN_PROFILE_TIMED] = {"Timed", 0, NEW_SCAN_TIMER_MS, NETWORK_MAX_AGE_SCANS, false},
+    [SCAN_PROFILE_PASSIVE] = {"Passive", 1, NEW_SCAN_TIMER_MS, NETWORK_MAX_AGE_SCANS, false},
+};
+
+/** @brief Measurements of each profile. */
+static scan_profile_stats_t profileStats[SCAN_PROFILE_COUNT];
+
+/** @brief Profile chosen by the UI and profile of the pipeline. */
+static volatile scan_profile_t requestedProfile = DEFAULT_SCAN_PROFILE;
+static scan_profile_t activeProfile = DEFAULT_SCAN_PROFILE;
+
+/** @brief Pause after the current sweep, adapted to the churn. */
+static volatile uint32_t scanIntervalMs = 0;
+/** @brief Churn score of the last sweep. */
+static volatile uint32_t churnScore = 0;
+/** @brief Whether the table was filled by a previous sweep, so the churn is meaningful. */
+static bool churnReady = false;
+
+/** @brief Channel group of the last result of the sweep, 0 before the first. */
+static int resultGroup = 0;
+
+/**
+ * @brief Tracking request written by the UI, applied when trackRequestSeq changes.
+ *
+ * trackRequestSeq is odd while the UI writes the request (seqlock).
+ */
+static uint8_t trackRequestBssid[6];
+static char trackRequestSsid[33];
+static bool trackRequestOn = false;
+static volatile uint32_t trackRequestSeq = 0;
+static uint32_t trackAppliedSeq = 0;
+
+/** @brief Network being tracked by the pipeline. */
+static bool tracking = false;
+static uint8_t trackBssid[6];
+static char trackSsid[33];
+/** @brief Whether the scan in progress is a directed tracking scan. */
+static bool trackingScan = false;
+
+/** @brief Tracked samples, written by the pipeline and read by the UI. */
+static int8_t trackSamples[TRACK_HISTORY_LEN];
+static volatile uint32_t trackSampleTotal = 0;
+
+/** @brief Set by core 1 once the Wi-Fi driver initialization finished. */
+static volatile bool wifiInitDone = false;
+/** @brief Result of cyw43_arch_init on core 1. */
+static volatile int wifiInitError = 0;
+
+// Função chamada automaticamente sempre que um resultado de varredura
+// é encontrado. O resultado é passado como argumento (result).
+// Roda no contexto do driver: apenas copia o resultado para o anel.
+static int scanResult(void *env, const cyw43_ev_scan_result_t *result)
+{
+    // Pular redes com SSID vazio ou nulo
+    if (!result || result->ssid_len == 0 || result->ssid[0] == '\0')
+        return 0;
+
+    scanRingPush(&scanRing, result); // Se o anel estiver cheio, conta o descarte
+    return 0; // Retorna 0 para continuar a varredura.
+}
+
+/**
+ * @brief Merges the results waiting in the ring into the network table.
+ *
+ * @param max Maximum number of results to merge.
+ */
+static void drainScanResults(int max)
+{
+    const scan_record_t *record;
+    bool added;
+
+    while (max-- > 0 && (record = scanRingPeek(&scanRing)) != NULL)
+    {
+        // O firmware percorre os canais em ordem: um resultado de outro grupo
+        // indica que o grupo anterior terminou, e ele é publicado
+        if (scanProfiles[activeProfile].publishPerGroup && !trackingScan)
+        {
+            int group = (record->channel - 1) / SCAN_CHANNEL_GROUP_SIZE + 1;
+            if (group != resultGroup && resultGroup != 0)
+            {
+                publishNetworks();
+            }
+            resultGroup = group;
+        }
+
+        storeScanResult(record, &added); // A tela só vê a rede quando for publicada
+
+        // Amostra da rede rastreada: vai direto para o gráfico
+        if (tracking && memcmp(record->bssid, trackBssid, sizeof(trackBssid)) == 0)
+        {
+            uint32_t total = trackSampleTotal;
+            trackSamples[total % TRACK_HISTORY_LEN] = record->rssi < INT8_MIN ? INT8_MIN : record->rssi;
+            __dmb();
+            trackSampleTotal = total + 1;
+        }
+        scanRingRelease(&scanRing);
+    }
+}
+
+/**
+ * @brief Applies the last tracking request made by the UI.
+ */
+static void applyTrackingRequest()
+{
+    uint32_t seq;
+    bool on;
+
+    // Copia de novo se a UI escrevia o pedido durante a cópia
+    do
+    {
+        seq = trackRequestSeq;
+        if (seq == trackAppliedSeq)
+        {
+            return;
+        }
+        __dmb();
+        on = trackRequestOn;
+        memcpy(trackBssid, trackRequestBssid, sizeof(trackBssid));
+        memcpy(trackSsid, trackRequestSsid, sizeof(trackSsid));
+        __dmb();
+    } while ((seq & 1) || seq != trackRequestSeq);
+
+    trackAppliedSeq = seq;
+    tracking = on;
+    if (tracking)
+    {
+        trackSampleTotal = 0;
+        printf("Rastreando a rede: %s\n", trackSsid);
+    }
+
+    // A próxima varredura começa assim que a atual terminar
+    scanTime = get_absolute_time();
+}
+
+void requestTracking(const wifi_network_t *network)
+{
+    trackRequestSeq++; // Ímpar: pedido sendo escrito
+    __dmb();
+    trackRequestOn = network != NULL;
+    if (network != NULL)
+    {
+        memcpy(trackRequestBssid, network->bssid, sizeof(trackRequestBssid));
+        memcpy(trackRequestSsid, network->ssid, sizeof(trackRequestSsid));
+    }
+    __dmb();
+    trackRequestSeq++;
+}
+
+int getTrackedSamples(int8_t *samples, int max)
+{
+    uint32_t total = trackSampleTotal;
+    __dmb();
+
+    int count = total < TRACK_HISTORY_LEN ? total : TRACK_HISTORY_LEN;
+    if (count > max)
+    {
+        count = max;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        samples[i] = trackSamples[(total - count + i) % TRACK_HISTORY_LEN];
+    }
+    return count;
+}
+
+uint32_t getTrackedSampleCount()
+{
+    return trackSampleTotal;
+}
+
+void setScanProfile(scan_profile_t profile)
+{
+    requestedProfile = profile;
+}
+
+scan_profile_t getScanProfile()
+{
+    return requestedProfile;
+}
+
+const scan_profile_config_t *getScanProfileConfig(scan_profile_t profile)
+{
+    return &scanProfiles[profile];
+}
+
+const scan_profile_stats_t *getScanProfileStats(scan_profile_t profile)
+{
+    return &profileStats[profile];
+}
+
+uint32_t getScanInterval()
+{
+    return scanIntervalMs;
+}
+
+uint32_t getScanChurnScore()
+{
+    return churnScore;
+}
+
+/**
+ * @brief Chooses the pause after a sweep from the churn measured in it.
+ */
+static void adaptScanInterval()
+{
+    scan_churn_t churn;
+    measureScanChurn(&churn);
+    churnScore = churn.added + churn.lost + churn.rssiDeltaDb / SCAN_CHURN_RSSI_DB;
+
+    // A primeira varredura só preenche a tabela; perfis sem pausa não se adaptam
+    uint32_t interval = scanIntervalMs;
+    if (ADAPTIVE_SCAN_INTERVAL && churnReady && interval > 0)
+    {
+        if (churnScore >= SCAN_CHURN_HIGH)
+        {
+            interval /= 2; // Ambiente mudando: varre mais vezes
+        }
+        else if (churnScore == 0)
+        {
+            interval += interval / 2; // Nada mudou: economiza rádio
+        }
+
+        if (interval < SCAN_INTERVAL_FLOOR_MS)
+        {
+            interval = SCAN_INTERVAL_FLOOR_MS;
+        }
+        else if (interval > SCAN_INTERVAL_CEILING_MS)
+        {
+            interval = SCAN_INTERVAL_CEILING_MS;
+        }
+        scanIntervalMs = interval;
+    }
+    churnReady = true;
+
+    printf("Mudanças: %u novas, %u perdidas, %lu dB (nota %lu) -> próxima varredura em %lu ms\n",
+           churn.added, churn.lost, (unsigned long)churn.rssiDeltaDb,
+           (unsigned long)churnScore, (unsigned long)scanIntervalMs);
+}
+
+/**
+ * @brief Switches to the profile chosen by the UI between sweeps.
+ */
+static void applyScanProfile()
+{
+    scan_profile_t profile = requestedProfile;
+    if (scanning || profile == activeProfile)
+    {
+        return;
+    }
+
+    activeProfile = profile;
+    scanIntervalMs = scanProfiles[profile].intervalMs; // A adaptação recomeça da pausa do perfil
+    printf("Perfil de varredura: %s\n", scanProfiles[profile].name);
+    scanTime = get_absolute_time(); // O novo perfil começa já
+}
+
+/**
+ * @brief Initializes the Wi-Fi driver in station mode.
+ */
+static int initWifi()
+{
+    int err = cyw43_arch_init();
+    if (err == 0)
+    {
+        // Ativa o modo Station (STA)
+        cyw43_arch_enable_sta_mode();
+    }
+    return err;
+}
+
+/**
+ * @brief Entry point of core 1: owns the Wi-Fi driver and the scan pipeline.
+ */
+static void scanCoreMain()
+{
+    wifiInitError = initWifi();
+    __dmb();
+    wifiInitDone = true;
+
+    while (wifiInitError == 0)
+    {
+        updateScanTask();
+        sleep_ms(SCAN_CORE_TICK_MS);
+    }
+
+    while (true)
+    {
+        __wfe();
+    }
+}
+
+bool startScanTask()
+{
+    initScanRing(&scanRing);
+
+    // Inicia varredura imediatamente.
+    scanTime = get_absolute_time();
+    scanIntervalMs = scanProfiles[activeProfile].intervalMs;
+    scanning = false;
+
+#if SCAN_ON_CORE1
+    // O núcleo 1 grava o cache de conexões na flash: o núcleo 0 precisa poder ser pausado
+    flash_safe_execute_core_init();
+    multicore_launch_core1(scanCoreMain);
+    while (!wifiInitDone)
+    {
+        tight_loop_contents();
+    }
+    __dmb();
+    return wifiInitError == 0;
+#else
+    return initWifi() == 0;
+#endif
+}
+
+void updateScanTask()
+{
+    applyTrackingRequest();
+    applyScanProfile();
+    updateConnect(); // A conexão pedida pela interface avança no núcleo do driver
+
+    // Com uma conexão em andamento, a varredura atual termina e nenhuma outra começa
+    bool scanAllowed = scanning || !isConnectBusy();
+    if (scanAllowed && absolute_time_diff_us(get_absolute_time(), scanTime) < 0)
+    {
+        // Se nenhuma varredura estiver em andamento, inicia uma nova varredura.
+        if (!scanning)
+        {
+            // Cria uma estrutura para configurar as opções de varredura.
+            cyw43_wifi_scan_options_t scanOptions = {0};
+            scanOptions.scan_type = scanProfiles[activeProfile].scanType;
+
+            // No rastreamento, a varredura procura só o SSID da rede. O driver
+            // sobrescreve a lista de canais e os tempos de permanência, então
+            // a taxa vem de repetir varreduras curtas sem intervalo.
+            trackingScan = tracking;
+            if (trackingScan)
+            {
+                scanOptions.ssid_len = strlen(trackSsid);
+                memcpy(scanOptions.ssid, trackSsid, scanOptions.ssid_len);
+            }
+
+            // Inicia a varredura wi-fi utilizando as opções configuradas.
+            int err = cyw43_wifi_scan(&cyw43_state, &scanOptions, NULL, scanResult);
+
+            if (err == 0)
+            {
+                if (!trackingScan)
+                {
+                    printf("Iniciando varredura...\n");
+                    beginNetworkScan(); // Redes antigas ficam até expirarem
+                }
+                scanning = true;
+                sweepStart = get_absolute_time();
+                resultGroup = 0;
+                liveUpdateTime = make_timeout_time_ms(LIVE_SCAN_UPDATE_MS);
+            }
+            else
+            {
+                printf("Erro ao iniciar varredura: %d\n", err);
+                scanTime = make_timeout_time_ms(NEW_SCAN_TIMER_MS);
+            }
+        }
+        else if (!cyw43_wifi_scan_active(&cyw43_state) && trackingScan)
+        {
+            // Varredura dirigida: sem expiração, a próxima começa em seguida
+            drainScanResults(SCAN_RING_SIZE);
+            publishNetworks();
+            scanTime = make_timeout_time_ms(TRACK_SCAN_INTERVAL_MS);
+            scanning = false;
+        }
+        else if (!cyw43_wifi_scan_active(&cyw43_state))
+        {
+            // Incorpora os últimos resultados e remove as redes que não aparecem há algumas varreduras
+            drainScanResults(SCAN_RING_SIZE);
+            const scan_profile_config_t *profile = &scanProfiles[activeProfile];
+            scan_profile_stats_t *stats = &profileStats[activeProfile];
+            stats->lastDurationMs = absolute_time_diff_us(sweepStart, get_absolute_time()) / 1000;
+            stats->totalDurationMs += stats->lastDurationMs;
+            stats->lastFound = countSeenNetworks();
+            stats->sweeps++;
+
+            int expired = expireNetworks(profile->maxAgeScans);
+            adaptScanInterval();
+            publishNetworks();
+            printf("Varredura concluída no núcleo %u (%lu descartadas, %lu substituídas, %d expiradas)\n",
+                   get_core_num(), (unsigned long)networksDropped,
+                   (unsigned long)networksEvicted, expired);
+            printf("Perfil %s: %lu ms, %u redes (média %lu ms em %lu varreduras)\n",
+                   profile->name, (unsigned long)stats->lastDurationMs, stats->lastFound,
+                   (unsigned long)(stats->totalDurationMs / stats->sweeps), (unsigned long)stats->sweeps);
+            printf("Anel de resultados: %lu perdidos, ocupação máxima %lu/%d\n",
+                   (unsigned long)scanRing.overflows, (unsigned long)scanRing.highWater, SCAN_RING_SIZE);
+            printNetworkReport();
+
+            scanTime = make_timeout_time_ms(scanIntervalMs);
+            scanning = false;
+        }
+    }
+
+    drainScanResults(SCAN_DRAIN_BATCH);
+
+    // Resultados parciais enquanto a varredura continua
+    if (scanning && LIVE_SCAN_UPDATE_MS > 0 && !scanProfiles[activeProfile].publishPerGroup && absolute_time_diff_us(get_absolute_time(), liveUpdateTime) < 0)
+    {
+        publishNetworks();
+        liveUpdateTime = make_timeout_time_ms(LIVE_SCAN_UPDATE_MS);
+    }
+}
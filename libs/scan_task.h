@@ -0,0 +1,189 @@
+/**
+ * @file scan_task.h
+ * @brief Header file for the Wi-Fi scan pipeline.
+ *
+ * Starts scans on a timer, merges the results from the scan ring into the
+ * network table and publishes snapshots of it for the UI. The pipeline runs
+ * from the main loop or, with SCAN_ON_CORE1, on its own loop on core 1,
+ * where the cyw43 driver is also initialized so its interrupts stay off
+ * the UI core.
+ *
+ * Scans follow a profile chosen at run time (see scan_profile_t); each
+ * profile keeps the measured duration of its sweeps and the number of
+ * networks they found. The cyw43 driver passes only the SSID and the scan
+ * type on to the firmware and overrides the probe count, the dwell times
+ * and the channel list, so every sweep covers all channels with the
+ * firmware's timing: profiles change only the scan type, the pause between
+ * sweeps, how long networks may be missing and how often the list is
+ * published. With ADAPTIVE_SCAN_INTERVAL, the pause of the timed
+ * profiles follows the churn between sweeps: it halves while networks
+ * appear, disappear or change signal, and grows while nothing changes.
+ *
+ * In tracking mode the pipeline runs scans directed at one SSID back to
+ * back and records every RSSI sample of the tracked BSSID in a ring the UI
+ * reads for its live graph. Expiry is paused meanwhile, since directed
+ * scans do not see the other networks.
+ */
+
+#ifndef SCAN_TASK_H
+#define SCAN_TASK_H
+
+#include "pico/stdlib.h"
+#include "scan_ring.h"
+#include "patro_wifi_scanner.h"
+
+/** @brief Runs the scan pipeline and the cyw43 driver on core 1. */
+#ifndef SCAN_ON_CORE1
+#define SCAN_ON_CORE1 0
+#endif
+
+/** @brief Time between the end of a scan and the start of the next one. */
+#ifndef NEW_SCAN_TIMER_MS
+#define NEW_SCAN_TIMER_MS 10000
+#endif
+
+/** @brief Interval between partial snapshots while a scan runs (0 disables). */
+#ifndef LIVE_SCAN_UPDATE_MS
+#define LIVE_SCAN_UPDATE_MS 1000
+#endif
+
+/** @brief Adapts the pause between sweeps to the churn of the environment. */
+#ifndef ADAPTIVE_SCAN_INTERVAL
+#define ADAPTIVE_SCAN_INTERVAL 1
+#endif
+
+/** @brief Shortest pause between sweeps chosen by the adaptive schedule. */
+#ifndef SCAN_INTERVAL_FLOOR_MS
+#define SCAN_INTERVAL_FLOOR_MS 3000
+#endif
+
+/** @brief Longest pause between sweeps chosen by the adaptive schedule. */
+#ifndef SCAN_INTERVAL_CEILING_MS
+#define SCAN_INTERVAL_CEILING_MS 60000
+#endif
+
+/** @brief Summed RSSI change, in dB, that counts as one changed network. */
+#ifndef SCAN_CHURN_RSSI_DB
+#define SCAN_CHURN_RSSI_DB 10
+#endif
+
+/** @brief Churn score from which the pause is halved; a score of 0 grows it by half. */
+#ifndef SCAN_CHURN_HIGH
+#define SCAN_CHURN_HIGH 2
+#endif
+
+/** @brief Profile used from startup. */
+#ifndef DEFAULT_SCAN_PROFILE
+#define DEFAULT_SCAN_PROFILE SCAN_PROFILE_TIMED
+#endif
+
+/** @brief Channels per group when a profile publishes per channel group. */
+#ifndef SCAN_CHANNEL_GROUP_SIZE
+#define SCAN_CHANNEL_GROUP_SIZE 4
+#endif
+
+/** @brief Maximum number of results merged per call to updateScanTask. */
+#define SCAN_DRAIN_BATCH 16
+
+/** @brief Period of the scan loop on core 1. */
+#define SCAN_CORE_TICK_MS 5
+
+/** @brief Pause between directed scans in tracking mode. */
+#ifndef TRACK_SCAN_INTERVAL_MS
+#define TRACK_SCAN_INTERVAL_MS 0
+#endif
+
+/** @brief Number of tracked RSSI samples kept for the graph, a power of two. */
+#define TRACK_HISTORY_LEN 64
+
+/** @brief Scan profiles selectable at run time. */
+typedef enum {
+    SCAN_PROFILE_NONSTOP,    // Varreduras ativas seguidas, publicadas a cada grupo de canais
+    SCAN_PROFILE_TIMED,      // Varredura ativa a cada NEW_SCAN_TIMER_MS
+    SCAN_PROFILE_PASSIVE,    // Varredura passiva a cada NEW_SCAN_TIMER_MS: não envia sondas
+    SCAN_PROFILE_COUNT
+} scan_profile_t;
+
+/** @brief Settings of a scan profile. */
+typedef struct {
+    const char *name;
+    uint8_t scanType;      // 0 ativa, 1 passiva (cyw43_wifi_scan_options_t.scan_type)
+    uint32_t intervalMs;   // Pausa entre o fim de uma varredura e o início da próxima
+    uint32_t maxAgeScans;  // Varreduras que uma rede pode faltar antes de expirar
+    bool publishPerGroup;  // Publica a lista a cada grupo de canais visto; a varredura cobre todos
+} scan_profile_config_t;
+
+/** @brief Measurements of the sweeps made with a profile. */
+typedef struct {
+    uint32_t sweeps;          // Varreduras concluídas
+    uint32_t lastDurationMs;  // Duração da última varredura
+    uint32_t totalDurationMs; // Soma das durações, para a média
+    uint16_t lastFound;       // Redes vistas na última varredura
+} scan_profile_stats_t;
+
+/** @brief Results delivered by the scan callback. */
+extern scan_ring_t scanRing;
+
+/**
+ * @brief Initializes the Wi-Fi driver in station mode and the scan pipeline.
+ *
+ * With SCAN_ON_CORE1 the driver is initialized by core 1, and this call
+ * waits until it is done.
+ *
+ * @return true if the Wi-Fi driver was initialized.
+ */
+bool startScanTask();
+
+/**
+ * @brief Runs one step of the scan pipeline: starts or finishes a scan,
+ *        merges pending results and publishes snapshots.
+ *
+ * Called from the main loop when SCAN_ON_CORE1 is disabled.
+ */
+void updateScanTask();
+
+/**
+ * @brief Selects the scan profile (UI side).
+ *
+ * The profile is applied when the scan in progress finishes.
+ */
+void setScanProfile(scan_profile_t profile);
+
+/** @brief Returns the selected scan profile. */
+scan_profile_t getScanProfile();
+
+/** @brief Returns the settings of a scan profile. */
+const scan_profile_config_t *getScanProfileConfig(scan_profile_t profile);
+
+/** @brief Returns the sweep measurements of a scan profile. */
+const scan_profile_stats_t *getScanProfileStats(scan_profile_t profile);
+
+/** @brief Returns the pause currently used between sweeps, in milliseconds. */
+uint32_t getScanInterval();
+
+/** @brief Returns the churn score of the last sweep. */
+uint32_t getScanChurnScore();
+
+/**
+ * @brief Asks the scan pipeline to track a network (UI side).
+ *
+ * The request is applied by the pipeline on its next step; the scan in
+ * progress is finished first.
+ *
+ * @param network Network to track, or NULL to go back to full scans.
+ */
+void requestTracking(const wifi_network_t *network);
+
+/**
+ * @brief Copies the newest tracked RSSI samples, oldest first (UI side).
+ *
+ * @param samples Receives up to max samples.
+ * @param max Capacity of samples.
+ * @return Number of samples copied.
+ */
+int getTrackedSamples(int8_t *samples, int max);
+
+/** @brief Returns the number of tracked samples recorded since tracking started. */
+uint32_t getTrackedSampleCount();
+
+#endif // SCAN_TASK_H
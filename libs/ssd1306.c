@@ -34,18 +34,25 @@ SOFTWARE.
 #include "font.h"
 
 inline static void swap(int32_t *a, int32_t *b) {
-    int32_t *t=a;
+    int32_t t=*a;
     *a=*b;
-    *b=*t;
+    *b=t;
 }
 
-inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
-    switch(i2c_write_blocking(i2c, addr, src, len, false)) {
+static int ssd1306_i2c_write(ssd1306_bus_t *bus, uint8_t addr, const uint8_t *src, size_t len) {
+    return i2c_write_blocking((i2c_inst_t *) bus->ctx, addr, src, len, false);
+}
+
+inline static void fancy_write(ssd1306_t *p, const uint8_t *src, size_t len, char *name) {
+    ++(p->transactions);
+    switch(p->bus.write(&p->bus, p->address, src, len)) {
     case PICO_ERROR_GENERIC:
         printf("[%s] addr not acknowledged!\n", name);
+        ssd1306_invalidate(p);
         break;
     case PICO_ERROR_TIMEOUT:
         printf("[%s] timeout!\n", name);
+        ssd1306_invalidate(p);
         break;
     default:
         //printf("[%s] wrote successfully %lu bytes!\n", name, len);
@@ -53,9 +60,80 @@ inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src
     }
 }
 
+// from https://github.com/makerportal/rpi-pico-ssd1306
+// geometry and vcc dependent settings are appended by ssd1306_init
+static const uint8_t ssd1306_init_cmds[]= {
+    SET_DISP,
+    // timing and driving scheme
+    SET_DISP_CLK_DIV,
+    0x80,
+    SET_DISP_OFFSET,
+    0x00,
+    // resolution and layout
+    SET_DISP_START_LINE,
+    SET_SEG_REMAP | 0x01,           // column addr 127 mapped to SEG0
+    SET_COM_OUT_DIR | 0x08,         // scan from COM[N] to COM0
+    // display
+    SET_CONTRAST,
+    0xff,
+    SET_VCOM_DESEL,
+    0x30,                           // or 0x40?
+    SET_ENTIRE_ON,                  // output follows RAM contents
+    SET_NORM_INV,                   // not inverted
+    // address setting
+    SET_MEM_ADDR,
+    0x00,  // horizontal
+};
+
+inline void ssd1306_cmdlist_begin(ssd1306_cmdlist_t *l) {
+    l->buf[0]=0x00; // Co=0, D/C#=0: every following byte is a command
+    l->len=1;
+    l->overflow=false;
+}
+
+inline void ssd1306_cmdlist_add(ssd1306_cmdlist_t *l, uint8_t cmd) {
+    if(l->len>=sizeof(l->buf)) {
+        l->overflow=true;
+        return;
+    }
+    l->buf[l->len++]=cmd;
+}
+
+void ssd1306_cmdlist_add_n(ssd1306_cmdlist_t *l, const uint8_t *cmds, size_t len) {
+    if(l->len+len>sizeof(l->buf)) {
+        l->overflow=true;
+        return;
+    }
+    memcpy(l->buf+l->len, cmds, len);
+    l->len+=len;
+}
+
+void ssd1306_cmdlist_send(ssd1306_t *p, const ssd1306_cmdlist_t *l) {
+    if(l->overflow) {
+        printf("[ssd1306_cmdlist_send] command list overflow!\n");
+        return;
+    }
+    if(l->len<2)
+        return;
+
+    ssd1306_flush_wait(p);
+    fancy_write(p, l->buf, l->len, "ssd1306_cmdlist_send");
+}
+
 inline static void ssd1306_write(ssd1306_t *p, uint8_t val) {
     uint8_t d[2]= {0x00, val};
-    fancy_write(p->i2c_i, p->address, d, 2, "ssd1306_write");
+    ssd1306_flush_wait(p);
+    fancy_write(p, d, 2, "ssd1306_write");
+}
+
+inline static void ssd1306_touch(ssd1306_t *p, uint32_t x, uint32_t page) {
+    if(x<p->dirty_lo[page]) p->dirty_lo[page]=x;
+    if(x>p->dirty_hi[page]) p->dirty_hi[page]=x;
+}
+
+inline static void ssd1306_mark_clean(ssd1306_t *p) {
+    memset(p->dirty_lo, 0xff, sizeof(p->dirty_lo));
+    memset(p->dirty_hi, 0x00, sizeof(p->dirty_hi));
 }
 
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance) {
@@ -65,7 +143,13 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
     p->address=address;
 
     p->i2c_i=i2c_instance;
+    p->bus=(ssd1306_bus_t) {
+        .write=ssd1306_i2c_write,
+        .ctx=i2c_instance,
+    };
 
+    if(p->pages>SSD1306_MAX_PAGES)
+        return false;
 
     p->bufsize=(p->pages)*(p->width);
     if((p->buffer=malloc(p->bufsize+1))==NULL) {
@@ -73,50 +157,75 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
         return false;
     }
 
+    if((p->shadow=malloc(p->bufsize))==NULL) {
+        free(p->buffer);
+        p->bufsize=0;
+        return false;
+    }
+
+    if((p->front=malloc(SSD1306_STAGE_CAPACITY(p->width, p->height)))==NULL) {
+        free(p->shadow);
+        free(p->buffer);
+        p->bufsize=0;
+        return false;
+    }
+    p->seg_count=0;
+
     ++(p->buffer);
+    memset(p->buffer, 0, p->bufsize);
 
-    // from https://github.com/makerportal/rpi-pico-ssd1306
-    uint8_t cmds[]= {
-        SET_DISP,
-        // timing and driving scheme
-        SET_DISP_CLK_DIV,
-        0x80,
-        SET_MUX_RATIO,
-        height - 1,
-        SET_DISP_OFFSET,
-        0x00,
-        // resolution and layout
-        SET_DISP_START_LINE,
-        // charge pump
-        SET_CHARGE_PUMP,
-        p->external_vcc?0x10:0x14,
-        SET_SEG_REMAP | 0x01,           // column addr 127 mapped to SEG0
-        SET_COM_OUT_DIR | 0x08,         // scan from COM[N] to COM0
-        SET_COM_PIN_CFG,
-        width>2*height?0x02:0x12,
-        // display
-        SET_CONTRAST,
-        0xff,
-        SET_PRECHARGE,
-        p->external_vcc?0x22:0xF1,
-        SET_VCOM_DESEL,
-        0x30,                           // or 0x40?
-        SET_ENTIRE_ON,                  // output follows RAM contents
-        SET_NORM_INV,                   // not inverted
-        SET_DISP | 0x01,
-        // address setting
-        SET_MEM_ADDR,
-        0x00,  // horizontal
-    };
+    ssd1306_mark_clean(p);
+    p->full_refresh=true;
+    p->frame_bytes=0;
+    p->frame_windows=0;
+    p->total_bytes=0;
+    p->frames=0;
+
+    p->transactions=0;
+
+    ssd1306_cmdlist_t l;
+    ssd1306_cmdlist_begin(&l);
+    ssd1306_cmdlist_add_n(&l, ssd1306_init_cmds, sizeof(ssd1306_init_cmds));
+    ssd1306_cmdlist_add(&l, SET_MUX_RATIO);
+    ssd1306_cmdlist_add(&l, height-1);
+    ssd1306_cmdlist_add(&l, SET_COM_PIN_CFG);
+    ssd1306_cmdlist_add(&l, width>2*height?0x02:0x12);
+    // charge pump
+    ssd1306_cmdlist_add(&l, SET_CHARGE_PUMP);
+    ssd1306_cmdlist_add(&l, p->external_vcc?0x10:0x14);
+    ssd1306_cmdlist_add(&l, SET_PRECHARGE);
+    ssd1306_cmdlist_add(&l, p->external_vcc?0x22:0xF1);
+    ssd1306_cmdlist_add(&l, SET_DISP | 0x01);
+    ssd1306_cmdlist_send(p, &l);
+
+    return true;
+}
 
-    for(size_t i=0; i<sizeof(cmds); ++i)
-        ssd1306_write(p, cmds[i]);
+bool ssd1306_init_canvas(ssd1306_t *p, uint16_t width, uint16_t height) {
+    memset(p, 0, sizeof(*p));
+    p->width=width;
+    p->height=height;
+    p->pages=height/8;
 
+    if(p->pages>SSD1306_MAX_PAGES)
+        return false;
+
+    p->bufsize=(p->pages)*(p->width);
+    if((p->buffer=calloc(p->bufsize+1, 1))==NULL) {
+        p->bufsize=0;
+        return false;
+    }
+    ++(p->buffer);
+
+    ssd1306_mark_clean(p);
     return true;
 }
 
 inline void ssd1306_deinit(ssd1306_t *p) {
+    ssd1306_flush_wait(p);
     free(p->buffer-1);
+    free(p->shadow);
+    free(p->front);
 }
 
 inline void ssd1306_poweroff(ssd1306_t *p) {
@@ -128,62 +237,354 @@ inline void ssd1306_poweron(ssd1306_t *p) {
 }
 
 inline void ssd1306_contrast(ssd1306_t *p, uint8_t val) {
-    ssd1306_write(p, SET_CONTRAST);
-    ssd1306_write(p, val);
+    ssd1306_cmdlist_t l;
+    ssd1306_cmdlist_begin(&l);
+    ssd1306_cmdlist_add(&l, SET_CONTRAST);
+    ssd1306_cmdlist_add(&l, val);
+    ssd1306_cmdlist_send(p, &l);
 }
 
 inline void ssd1306_invert(ssd1306_t *p, uint8_t inv) {
     ssd1306_write(p, SET_NORM_INV | (inv & 1));
 }
 
+void ssd1306_scroll_horizontal(ssd1306_t *p, bool left, uint8_t start_page, uint8_t end_page, uint8_t interval) {
+    ssd1306_cmdlist_t l;
+    ssd1306_cmdlist_begin(&l);
+    ssd1306_cmdlist_add(&l, SET_SCROLL_STOP);   // scroll setup is only valid while scrolling is stopped
+    ssd1306_cmdlist_add(&l, left?SET_SCROLL_LEFT:SET_SCROLL_RIGHT);
+    ssd1306_cmdlist_add(&l, 0x00);
+    ssd1306_cmdlist_add(&l, start_page);
+    ssd1306_cmdlist_add(&l, interval&0x07);
+    ssd1306_cmdlist_add(&l, end_page);
+    ssd1306_cmdlist_add(&l, 0x00);
+    ssd1306_cmdlist_add(&l, 0xff);
+    ssd1306_cmdlist_add(&l, SET_SCROLL_START);
+    ssd1306_cmdlist_send(p, &l);
+}
+
+void ssd1306_scroll_stop(ssd1306_t *p) {
+    ssd1306_write(p, SET_SCROLL_STOP);
+    // scrolling moved the display ram, rewrite it from the buffer
+    ssd1306_invalidate(p);
+}
+
 inline void ssd1306_clear(ssd1306_t *p) {
     memset(p->buffer, 0, p->bufsize);
+    memset(p->dirty_lo, 0, p->pages);
+    memset(p->dirty_hi, p->width-1, p->pages);
+}
+
+void ssd1306_mark_dirty(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    if(x>=p->width || y>=p->height || width==0 || height==0) return;
+
+    uint32_t x_end=MIN(x+width, p->width)-1;
+    uint32_t page_end=(MIN(y+height, p->height)-1)>>3;
+
+    for(uint32_t page=y>>3; page<=page_end; ++page) {
+        ssd1306_touch(p, x, page);
+        ssd1306_touch(p, x_end, page);
+    }
 }
 
 void ssd1306_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
     if(x>=p->width || y>=p->height) return;
 
     p->buffer[x+p->width*(y>>3)]&=~(0x1<<(y&0x07));
+    ssd1306_touch(p, x, y>>3);
 }
 
 void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
     if(x>=p->width || y>=p->height) return;
 
     p->buffer[x+p->width*(y>>3)]|=0x1<<(y&0x07); // y>>3==y/8 && y&0x7==y%8
+    ssd1306_touch(p, x, y>>3);
+}
+
+enum {
+    CLIP_LEFT=1,
+    CLIP_RIGHT=2,
+    CLIP_TOP=4,
+    CLIP_BOTTOM=8,
+};
+
+inline static uint8_t ssd1306_clip_code(ssd1306_t *p, int32_t x, int32_t y) {
+    uint8_t code=0;
+    if(x<0) code|=CLIP_LEFT;
+    else if(x>=p->width) code|=CLIP_RIGHT;
+    if(y<0) code|=CLIP_TOP;
+    else if(y>=p->height) code|=CLIP_BOTTOM;
+    return code;
+}
+
+inline static int32_t ssd1306_div_round(int64_t num, int64_t den) {
+    if(den<0) {
+        num=-num;
+        den=-den;
+    }
+    return (int32_t) (num>=0?(num+den/2)/den:-((-num+den/2)/den));
+}
+
+// Cohen-Sutherland: moves both end points onto the display, false if the line misses it
+static bool ssd1306_clip_line(ssd1306_t *p, int32_t *x1, int32_t *y1, int32_t *x2, int32_t *y2) {
+    uint8_t c1=ssd1306_clip_code(p, *x1, *y1);
+    uint8_t c2=ssd1306_clip_code(p, *x2, *y2);
+
+    // intersections are taken on the original line so rounding does not accumulate
+    const int32_t ox=*x1, oy=*y1;
+    const int64_t dx=(int64_t) *x2-*x1, dy=(int64_t) *y2-*y1;
+
+    while(c1|c2) {
+        if(c1&c2)
+            return false;
+
+        uint8_t c=c1?c1:c2;
+        int32_t x, y;
+
+        if(c&CLIP_BOTTOM) {
+            y=p->height-1;
+            x=ox+ssd1306_div_round(dx*(y-oy), dy);
+        } else if(c&CLIP_TOP) {
+            y=0;
+            x=ox+ssd1306_div_round(dx*(y-oy), dy);
+        } else if(c&CLIP_RIGHT) {
+            x=p->width-1;
+            y=oy+ssd1306_div_round(dy*(x-ox), dx);
+        } else {
+            x=0;
+            y=oy+ssd1306_div_round(dy*(x-ox), dx);
+        }
+
+        if(c==c1) {
+            *x1=x;
+            *y1=y;
+            c1=ssd1306_clip_code(p, x, y);
+        } else {
+            *x2=x;
+            *y2=y;
+            c2=ssd1306_clip_code(p, x, y);
+        }
+    }
+    return true;
 }
 
 void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    if(!ssd1306_clip_line(p, &x1, &y1, &x2, &y2))
+        return;
+
     if(x1>x2) {
         swap(&x1, &x2);
         swap(&y1, &y2);
     }
 
+    // spans are written a byte (or page) at a time
+    if(y1==y2) {
+        ssd1306_fill_rect(p, x1, y1, x2-x1+1, 1, SSD1306_ROP_SET);
+        return;
+    }
     if(x1==x2) {
-        if(y1>y2)
-            swap(&y1, &y2);
-        for(int32_t i=y1; i<=y2; ++i)
-            ssd1306_draw_pixel(p, x1, i);
+        ssd1306_fill_rect(p, x1, MIN(y1, y2), 1, abs(y2-y1)+1, SSD1306_ROP_SET);
         return;
     }
 
-    float m=(float) (y2-y1) / (float) (x2-x1);
+    // Bresenham, every point is on the display after clipping
+    int32_t dx=x2-x1, dy=-abs(y2-y1);
+    int32_t sy=y1<y2?1:-1;
+    int32_t err=dx+dy;
+
+    for(;;) {
+        p->buffer[x1+p->width*(y1>>3)]|=0x1<<(y1&0x07);
+        ssd1306_touch(p, x1, y1>>3);
+
+        if(x1==x2 && y1==y2)
+            break;
+
+        int32_t e2=2*err;
+        if(e2>=dy) {
+            err+=dy;
+            ++x1;
+        }
+        if(e2<=dx) {
+            err+=dx;
+            y1+=sy;
+        }
+    }
+}
+
+void ssd1306_draw_polyline(ssd1306_t *p, const ssd1306_point_t *points, size_t count) {
+    for(size_t i=1; i<count; ++i)
+        ssd1306_draw_line(p, points[i-1].x, points[i-1].y, points[i].x, points[i].y);
+}
+
+void ssd1306_draw_circle(ssd1306_t *p, int32_t x0, int32_t y0, uint32_t r) {
+    // midpoint circle, one octant mirrored eight times
+    int32_t x=r, y=0;
+    int32_t err=1-x;
+
+    while(x>=y) {
+        ssd1306_draw_pixel(p, x0+x, y0+y);
+        ssd1306_draw_pixel(p, x0+y, y0+x);
+        ssd1306_draw_pixel(p, x0-y, y0+x);
+        ssd1306_draw_pixel(p, x0-x, y0+y);
+        ssd1306_draw_pixel(p, x0-x, y0-y);
+        ssd1306_draw_pixel(p, x0-y, y0-x);
+        ssd1306_draw_pixel(p, x0+y, y0-x);
+        ssd1306_draw_pixel(p, x0+x, y0-y);
+
+        ++y;
+        if(err<0) {
+            err+=2*y+1;
+        } else {
+            --x;
+            err+=2*(y-x)+1;
+        }
+    }
+}
+
+// sin(0..90 degrees) in Q14
+static const int16_t ssd1306_sin_q14[91]= {
+        0,   286,   572,   857,  1143,  1428,  1713,  1997,  2280,  2563,
+     2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+     5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+     8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860, 10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+    12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+    14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+    16384,
+};
+
+inline static int32_t ssd1306_isin(int32_t deg) {
+    deg%=360;
+    if(deg<0) deg+=360;
+    if(deg<=90) return ssd1306_sin_q14[deg];
+    if(deg<=180) return ssd1306_sin_q14[180-deg];
+    if(deg<=270) return -ssd1306_sin_q14[deg-180];
+    return -ssd1306_sin_q14[360-deg];
+}
+
+inline static int32_t ssd1306_icos(int32_t deg) {
+    return ssd1306_isin(deg+90);
+}
+
+void ssd1306_draw_arc(ssd1306_t *p, int32_t x0, int32_t y0, uint32_t r, int32_t start, int32_t end) {
+    if(end<start)
+        end+=360*((start-end)/360+1);
+
+    // keep chords around two pixels long
+    int32_t step=r>0?114/(int32_t) r:15;
+    if(step<1) step=1;
+    if(step>15) step=15;
+
+    int32_t px=x0+(((int32_t) r*ssd1306_icos(start)+(1<<13))>>14);
+    int32_t py=y0-(((int32_t) r*ssd1306_isin(start)+(1<<13))>>14);
+
+    for(int32_t a=start; a<end;) {
+        a=MIN(a+step, end);
+        int32_t nx=x0+(((int32_t) r*ssd1306_icos(a)+(1<<13))>>14);
+        int32_t ny=y0-(((int32_t) r*ssd1306_isin(a)+(1<<13))>>14);
+        ssd1306_draw_line(p, px, py, nx, ny);
+        px=nx;
+        py=ny;
+    }
+}
+
+void ssd1306_fill_rect(ssd1306_t *p, int32_t x, int32_t y, int32_t width, int32_t height, ssd1306_rop_t rop) {
+    int32_t x0=MAX(x, 0);
+    int32_t y0=MAX(y, 0);
+    int32_t x1=(int32_t) MIN((int64_t) x+width, (int64_t) p->width);
+    int32_t y1=(int32_t) MIN((int64_t) y+height, (int64_t) p->height);
+
+    if(x0>=x1 || y0>=y1) return;
+
+    uint32_t page0=y0>>3;
+    uint32_t page1=(y1-1)>>3;
+    uint32_t n=x1-x0;
+
+    for(uint32_t page=page0; page<=page1; ++page) {
+        uint8_t mask=0xff;
+        if(page==page0) mask&=0xff<<(y0&0x07);
+        if(page==page1) mask&=0xff>>(7-((y1-1)&0x07));
+
+        uint8_t *row=p->buffer+page*p->width+x0;
+        switch(rop) {
+        case SSD1306_ROP_SET:
+            if(mask==0xff) memset(row, 0xff, n);
+            else for(uint32_t i=0; i<n; ++i) row[i]|=mask;
+            break;
+        case SSD1306_ROP_CLEAR:
+            if(mask==0xff) memset(row, 0x00, n);
+            else for(uint32_t i=0; i<n; ++i) row[i]&=~mask;
+            break;
+        case SSD1306_ROP_XOR:
+            for(uint32_t i=0; i<n; ++i) row[i]^=mask;
+            break;
+        }
 
-    for(int32_t i=x1; i<=x2; ++i) {
-        float y=m*(float) (i-x1)+(float) y1;
-        ssd1306_draw_pixel(p, i, (uint32_t) y);
+        ssd1306_touch(p, x0, page);
+        ssd1306_touch(p, x1-1, page);
     }
 }
 
+// the uint32_t coordinates of the square functions wrap around, callers pass negative ints through them
+inline static int32_t ssd1306_clamp_size(uint32_t size) {
+    return size>INT32_MAX?INT32_MAX:(int32_t) size;
+}
+
 void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    for(uint32_t i=0; i<width; ++i)
-        for(uint32_t j=0; j<height; ++j)
-            ssd1306_clear_pixel(p, x+i, y+j);
+    ssd1306_fill_rect(p, (int32_t) x, (int32_t) y, ssd1306_clamp_size(width), ssd1306_clamp_size(height), SSD1306_ROP_CLEAR);
 }
 
 void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
-    for(uint32_t i=0; i<width; ++i)
-        for(uint32_t j=0; j<height; ++j)
-            ssd1306_draw_pixel(p, x+i, y+j);
+    ssd1306_fill_rect(p, (int32_t) x, (int32_t) y, ssd1306_clamp_size(width), ssd1306_clamp_size(height), SSD1306_ROP_SET);
+}
+
+void ssd1306_invert_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+    ssd1306_fill_rect(p, (int32_t) x, (int32_t) y, ssd1306_clamp_size(width), ssd1306_clamp_size(height), SSD1306_ROP_XOR);
+}
+
+void ssd1306_blit(ssd1306_t *p, int32_t x, int32_t y, const uint16_t *cols, uint32_t width, uint32_t height, ssd1306_rop_t rop) {
+    if(height==0 || height>16) return;
+
+    const uint16_t mask=0xffff>>(16-height);
+    const int32_t page0=y>>3;
+    const uint32_t shift=y&0x07;
+
+    int32_t i0=MAX(-x, 0);
+    int32_t i1=(int32_t) MIN((int64_t) width, (int64_t) p->width-x);
+
+    // a 16 bit column shifted inside its first page covers up to three pages
+    for(int32_t k=0; k<3; ++k) {
+        int32_t page=page0+k;
+        if(page<0 || page>=p->pages) continue;
+
+        uint8_t *row=p->buffer+page*p->width;
+        bool touched=false;
+
+        for(int32_t i=i0; i<i1; ++i) {
+            uint8_t bits=(((uint32_t) (cols[i]&mask))<<shift)>>(8*k);
+            if(!bits) continue;
+
+            switch(rop) {
+            case SSD1306_ROP_SET:
+                row[x+i]|=bits;
+                break;
+            case SSD1306_ROP_CLEAR:
+                row[x+i]&=~bits;
+                break;
+            case SSD1306_ROP_XOR:
+                row[x+i]^=bits;
+                break;
+            }
+            touched=true;
+        }
+
+        if(touched) {
+            ssd1306_touch(p, x+i0, page);
+            ssd1306_touch(p, x+i1-1, page);
+        }
+    }
 }
 
 void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
@@ -193,11 +594,38 @@ void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t wi
     ssd1306_draw_line(p, x+width, y, x+width, y+height);
 }
 
+// ORs one font column byte into the one or two pages it covers
+inline static void ssd1306_blit_column(ssd1306_t *p, int32_t x, int32_t y, uint8_t bits) {
+    if(x<0 || x>=p->width || bits==0) return;
+
+    int32_t page=y>>3;
+    uint32_t shift=y&0x07;
+
+    if(page>=0 && page<p->pages) {
+        p->buffer[x+p->width*page]|=bits<<shift;
+        ssd1306_touch(p, x, page);
+    }
+    if(shift && page+1>=0 && page+1<p->pages) {
+        p->buffer[x+p->width*(page+1)]|=bits>>(8-shift);
+        ssd1306_touch(p, x, page+1);
+    }
+}
+
 void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
     if(c<font[3]||c>font[4])
         return;
 
     uint32_t parts_per_line=(font[0]>>3)+((font[0]&7)>0);
+
+    if(scale==1) {
+        // font columns already match the page layout, coordinates wrap like the pixel functions
+        const uint8_t *pp=font+(c-font[3])*font[1]*parts_per_line+5;
+        for(uint8_t w=0; w<font[1]; ++w)
+            for(uint32_t lp=0; lp<parts_per_line; ++lp)
+                ssd1306_blit_column(p, (int32_t) (x+w), (int32_t) (y+(lp<<3)), *pp++);
+        return;
+    }
+
     for(uint8_t w=0; w<font[1]; ++w) { // width
         uint32_t pp=(c-font[3])*font[1]*parts_per_line+w*parts_per_line+5;
         for(uint32_t lp=0; lp<parts_per_line; ++lp) {
@@ -290,17 +718,155 @@ inline void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long
     ssd1306_bmp_show_image_with_offset(p, data, size, 0, 0);
 }
 
-void ssd1306_show(ssd1306_t *p) {
-    uint8_t payload[]= {SET_COL_ADDR, 0, p->width-1, SET_PAGE_ADDR, 0, p->pages-1};
-    if(p->width==64) {
-        payload[1]+=32;
-        payload[2]+=32;
+inline void ssd1306_invalidate(ssd1306_t *p) {
+    p->full_refresh=true;
+}
+
+inline void ssd1306_set_bus(ssd1306_t *p, const ssd1306_bus_t *bus) {
+    ssd1306_flush_wait(p);
+    p->bus=*bus;
+}
+
+inline bool ssd1306_flush_busy(ssd1306_t *p) {
+    if(p->bus.busy && p->bus.busy(&p->bus))
+        return true;
+
+    // the shadow already holds the lost frame, only a full refresh brings the display back in sync
+    if(p->bus.aborted) {
+        p->bus.aborted=false;
+        ssd1306_invalidate(p);
     }
+    return false;
+}
+
+void ssd1306_flush_wait(ssd1306_t *p) {
+    while(ssd1306_flush_busy(p))
+        tight_loop_contents();
+}
+
+static uint8_t *ssd1306_stage_window(ssd1306_t *p, uint8_t *out, uint32_t page, uint32_t x0, uint32_t x1, uint32_t page_end) {
+    uint8_t col_offset=p->width==64?32:0;
+    uint8_t *cmd=out;
+
+    *out++=0x00;
+    *out++=SET_COL_ADDR;
+    *out++=x0+col_offset;
+    *out++=x1+col_offset;
+    *out++=SET_PAGE_ADDR;
+    *out++=page;
+    *out++=page_end;
+    p->seg_len[p->seg_count++]=out-cmd;
+
+    const uint8_t *start=p->buffer+page*p->width+x0;
+    size_t len=(page_end-page)*p->width+x1-x0+1;
+
+    *out++=0x40;
+    memcpy(out, start, len);
+    memcpy(p->shadow+(start-p->buffer), start, len);
+    out+=len;
+    p->seg_len[p->seg_count++]=len+1;
+
+    p->frame_bytes+=len;
+    ++(p->frame_windows);
+    return out;
+}
 
-    for(size_t i=0; i<sizeof(payload); ++i)
-        ssd1306_write(p, payload[i]);
+// copies every changed span into the front buffer as command/data transaction pairs
+static void ssd1306_stage(ssd1306_t *p) {
+    uint8_t *out=p->front;
 
-    *(p->buffer-1)=0x40;
+    p->seg_count=0;
+    p->frame_bytes=0;
+    p->frame_windows=0;
+    ++(p->frames);
 
-    fancy_write(p->i2c_i, p->address, p->buffer-1, p->bufsize+1, "ssd1306_show");
+    if(p->full_refresh) {
+        ssd1306_stage_window(p, out, 0, 0, p->width-1, p->pages-1);
+        p->full_refresh=false;
+        p->total_bytes+=p->frame_bytes;
+        ssd1306_mark_clean(p);
+        return;
+    }
+
+    // windows each page may use, later spans are folded into the page's last window
+    const uint32_t page_windows=SSD1306_MAX_WINDOWS/p->pages;
+
+    for(uint32_t page=0; page<p->pages; ++page) {
+        if(p->dirty_lo[page]>p->dirty_hi[page])
+            continue;
+
+        const uint8_t *row=p->buffer+page*p->width;
+        const uint8_t *old=p->shadow+page*p->width;
+        uint32_t x=p->dirty_lo[page];
+        uint32_t x_end=p->dirty_hi[page];
+        uint32_t spans=0, last_lo=0, last_hi=0;
+
+        // split the touched range into spans that actually changed
+        while(x<=x_end) {
+            while(x<=x_end && row[x]==old[x]) ++x;
+            if(x>x_end) break;
+
+            uint32_t span_start=x, span_end=x, gap=0;
+            for(++x; x<=x_end && gap<=SSD1306_SPAN_MERGE_GAP; ++x) {
+                if(row[x]!=old[x]) {
+                    span_end=x;
+                    gap=0;
+                } else {
+                    ++gap;
+                }
+            }
+            x=span_end+1;
+
+            if(spans==page_windows) {
+                last_hi=span_end;
+                continue;
+            }
+            if(spans>0)
+                out=ssd1306_stage_window(p, out, page, last_lo, last_hi, page);
+            last_lo=span_start;
+            last_hi=span_end;
+            ++spans;
+        }
+
+        if(spans>0)
+            out=ssd1306_stage_window(p, out, page, last_lo, last_hi, page);
+    }
+
+    p->total_bytes+=p->frame_bytes;
+    ssd1306_mark_clean(p);
 }
+
+static void ssd1306_send_staged(ssd1306_t *p) {
+    const uint8_t *src=p->front;
+    for(uint32_t i=0; i<p->seg_count; ++i) {
+        fancy_write(p, src, p->seg_len[i], "ssd1306_show");
+        src+=p->seg_len[i];
+    }
+}
+
+void ssd1306_show(ssd1306_t *p) {
+    ssd1306_flush_wait(p);
+    ssd1306_stage(p);
+    ssd1306_send_staged(p);
+}
+
+bool ssd1306_show_async(ssd1306_t *p) {
+    if(ssd1306_flush_busy(p))
+        return false;
+
+    ssd1306_stage(p);
+    if(p->seg_count==0)
+        return true;
+
+    if(p->bus.start) {
+        if(p->bus.start(&p->bus, p->address, p->front, p->seg_len, p->seg_count)) {
+            p->transactions+=p->seg_count;
+        } else {
+            printf("[ssd1306_show_async] transfer not started!\n");
+            ssd1306_invalidate(p);
+        }
+    } else {
+        ssd1306_send_staged(p);
+    }
+    return true;
+}
\ No newline at end of file
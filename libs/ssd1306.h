@@ -53,9 +53,93 @@ typedef enum {
     SET_DISP_CLK_DIV = 0xD5,
     SET_PRECHARGE = 0xD9,
     SET_VCOM_DESEL = 0xDB,
-    SET_CHARGE_PUMP = 0x8D
+    SET_CHARGE_PUMP = 0x8D,
+    SET_SCROLL_RIGHT = 0x26,
+    SET_SCROLL_LEFT = 0x27,
+    SET_SCROLL_STOP = 0x2E,
+    SET_SCROLL_START = 0x2F
 } ssd1306_command_t;
 
+/**
+*	@brief raster operation applied by fill functions
+*/
+typedef enum {
+    SSD1306_ROP_SET,	/**< turn pixels on */
+    SSD1306_ROP_CLEAR,	/**< turn pixels off */
+    SSD1306_ROP_XOR		/**< invert pixels */
+} ssd1306_rop_t;
+
+/**
+*	@brief point of a polyline
+*/
+typedef struct {
+    int16_t x;	/**< x position */
+    int16_t y;	/**< y position */
+} ssd1306_point_t;
+
+/**
+*	@brief maximum number of pages tracked for partial updates (64 pixel high display)
+*/
+#define SSD1306_MAX_PAGES 8
+
+/**
+*	@brief dirty spans on one page closer than this many columns are merged into a single window
+*
+*	each window costs a SET_COL_ADDR/SET_PAGE_ADDR sequence, so sending a few unchanged bytes is cheaper than a new window
+*/
+#ifndef SSD1306_SPAN_MERGE_GAP
+#define SSD1306_SPAN_MERGE_GAP 8
+#endif
+
+/**
+*	@brief maximum number of address windows in one frame
+*
+*	each page gets SSD1306_MAX_WINDOWS/pages windows, further spans on a page are merged into its last window
+*/
+#ifndef SSD1306_MAX_WINDOWS
+#define SSD1306_MAX_WINDOWS 16
+#endif
+
+_Static_assert(SSD1306_MAX_WINDOWS>=SSD1306_MAX_PAGES, "SSD1306_MAX_WINDOWS must allow one window per page");
+
+/**
+*	@brief largest number of command bytes in one command list
+*/
+#ifndef SSD1306_CMDLIST_MAX
+#define SSD1306_CMDLIST_MAX 32
+#endif
+
+/**
+*	@brief sequence of commands sent as a single control-prefixed i2c transaction
+*/
+typedef struct {
+    uint8_t buf[SSD1306_CMDLIST_MAX+1];	/**< control byte followed by the commands */
+    uint8_t len;	/**< used bytes in buf, control byte included */
+    bool overflow;	/**< set when a command did not fit, the list is then not sent */
+} ssd1306_cmdlist_t;
+
+/**
+*	@brief bytes needed to stage a frame of the given size, control and address bytes included
+*/
+#define SSD1306_STAGE_CAPACITY(width, height) ((width)*(height)/8+SSD1306_MAX_WINDOWS*8)
+
+/**
+*	@brief transport used to reach the display
+*
+*	write is mandatory and blocks until the transaction is done. start and busy are optional:
+*	when start is set, ssd1306_show_async hands the staged frame to it and returns immediately.
+*	A frame is sent as count consecutive transactions of lens[i] bytes packed in src.
+*	A transport that loses part of a started frame sets aborted, the driver then resends
+*	the whole buffer on the next show.
+*/
+typedef struct ssd1306_bus {
+    int (*write)(struct ssd1306_bus *bus, uint8_t address, const uint8_t *src, size_t len); /**< blocking transaction, returns bytes written or PICO_ERROR_* */
+    bool (*start)(struct ssd1306_bus *bus, uint8_t address, const uint8_t *src, const uint16_t *lens, size_t count); /**< begin non-blocking transactions */
+    bool (*busy)(struct ssd1306_bus *bus); /**< whether a started transfer is still in flight */
+    bool aborted; /**< set by the transport when a started transfer was cut short */
+    void *ctx; /**< transport specific data */
+} ssd1306_bus_t;
+
 /**
 *	@brief holds the configuration
 */
@@ -68,6 +152,19 @@ typedef struct {
     bool external_vcc; 	/**< whether display uses external vcc */ 
     uint8_t *buffer;	/**< display buffer */
     size_t bufsize;		/**< buffer size */
+    ssd1306_bus_t bus;	/**< transport, blocking i2c by default */
+    uint8_t *shadow;	/**< copy of the last frame transmitted to the display */
+    uint8_t *front;		/**< staged transactions of the frame being flushed */
+    uint16_t seg_len[2*SSD1306_MAX_WINDOWS];	/**< length of each staged transaction */
+    uint8_t seg_count;	/**< number of staged transactions */
+    uint8_t dirty_lo[SSD1306_MAX_PAGES];	/**< first touched column per page (dirty_lo>dirty_hi: page clean) */
+    uint8_t dirty_hi[SSD1306_MAX_PAGES];	/**< last touched column per page */
+    bool full_refresh;	/**< next show transmits the whole buffer regardless of the shadow */
+    uint32_t frame_bytes;	/**< data bytes sent by the last call to ssd1306_show */
+    uint32_t frame_windows;	/**< address windows sent by the last call to ssd1306_show */
+    uint32_t total_bytes;	/**< data bytes sent since initialization */
+    uint32_t frames;	/**< number of calls to ssd1306_show since initialization */
+    uint32_t transactions;	/**< i2c transactions issued since initialization */
 } ssd1306_t;
 
 /**
@@ -85,6 +182,22 @@ typedef struct {
 */
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance);
 
+/**
+*	@brief initialize an off-screen canvas
+*
+*	a canvas has a buffer for the drawing functions but no display behind it, it must
+*	not be passed to the show or command functions
+*
+*	@param[in] p : pointer to instance of ssd1306_t
+*	@param[in] width : width of canvas
+*	@param[in] height : heigth of canvas, multiple of 8
+*
+* 	@return bool.
+*	@retval true for Success
+*	@retval false if the buffer could not be allocated
+*/
+bool ssd1306_init_canvas(ssd1306_t *p, uint16_t width, uint16_t height);
+
 /**
 *	@brief deinitialize display
 *
@@ -127,14 +240,130 @@ void ssd1306_contrast(ssd1306_t *p, uint8_t val);
 */
 void ssd1306_invert(ssd1306_t *p, uint8_t inv);
 
+/**
+	@brief start an empty command list
+
+	@param[out] l : command list
+*/
+void ssd1306_cmdlist_begin(ssd1306_cmdlist_t *l);
+
+/**
+	@brief append one command or argument byte
+
+	@param[in] l : command list
+	@param[in] cmd : command or argument
+*/
+void ssd1306_cmdlist_add(ssd1306_cmdlist_t *l, uint8_t cmd);
+
+/**
+	@brief append a table of command and argument bytes
+
+	@param[in] l : command list
+	@param[in] cmds : commands
+	@param[in] len : number of bytes in cmds
+*/
+void ssd1306_cmdlist_add_n(ssd1306_cmdlist_t *l, const uint8_t *cmds, size_t len);
+
+/**
+	@brief send the whole command list in one transaction
+
+	@param[in] p : instance of display
+	@param[in] l : command list
+*/
+void ssd1306_cmdlist_send(ssd1306_t *p, const ssd1306_cmdlist_t *l);
+
+/**
+	@brief continuously scroll pages horizontally (done by the display, no transfers needed)
+
+	@param[in] p : instance of display
+	@param[in] left : scroll to the left instead of to the right
+	@param[in] start_page : first page to scroll
+	@param[in] end_page : last page to scroll
+	@param[in] interval : frames between steps, as encoded by the controller (0-7)
+*/
+void ssd1306_scroll_horizontal(ssd1306_t *p, bool left, uint8_t start_page, uint8_t end_page, uint8_t interval);
+
+/**
+	@brief stop scrolling, the next ssd1306_show rewrites the whole display
+
+	@param[in] p : instance of display
+*/
+void ssd1306_scroll_stop(ssd1306_t *p);
+
 /**
 	@brief display buffer, should be called on change
 
+	only the columns that differ from the last transmitted frame are sent,
+	grouped into one address window per dirty span
+
 	@param[in] p : instance of display
 
 */
 void ssd1306_show(ssd1306_t *p);
 
+/**
+	@brief queue buffer for display without waiting for the transfer
+
+	the changed spans are copied to the front buffer, so drawing may continue right away.
+	Falls back to a blocking transfer when the bus has no start function.
+
+	@param[in] p : instance of display
+
+	@return bool.
+	@retval true frame queued
+	@retval false previous flush still in flight, changes stay pending for the next call
+*/
+bool ssd1306_show_async(ssd1306_t *p);
+
+/**
+	@brief whether a frame queued by ssd1306_show_async is still being transferred
+
+	a frame the transport aborted forces a full refresh on the next show
+
+	@param[in] p : instance of display
+*/
+bool ssd1306_flush_busy(ssd1306_t *p);
+
+/**
+	@brief block until the frame in flight has been transferred
+
+	@param[in] p : instance of display
+*/
+void ssd1306_flush_wait(ssd1306_t *p);
+
+/**
+	@brief replace the transport used to reach the display
+
+	the bus is copied, so the caller may pass a temporary. ctx must outlive the display.
+
+	@param[in] p : instance of display
+	@param[in] bus : new transport
+*/
+void ssd1306_set_bus(ssd1306_t *p, const ssd1306_bus_t *bus);
+
+/**
+	@brief force the next ssd1306_show to transmit the whole buffer
+
+	use after anything that may have changed the display RAM behind the driver's back
+
+	@param[in] p : instance of display
+
+*/
+void ssd1306_invalidate(ssd1306_t *p);
+
+/**
+	@brief mark a region of the buffer as touched
+
+	drawing functions call this themselves, it is only needed when writing to p->buffer directly
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of region
+	@param[in] height : height of region
+*/
+void ssd1306_mark_dirty(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
 /**
 	@brief clear display buffer
 
@@ -164,6 +393,8 @@ void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
 /**
 	@brief draw line on buffer
 
+	integer only, clipped to the display before rasterizing
+
 	@param[in] p : instance of display
 	@param[in] x1 : x position of starting point
 	@param[in] y1 : y position of starting point
@@ -172,6 +403,39 @@ void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y);
 */
 void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
 
+/**
+	@brief draw connected line segments on buffer
+
+	@param[in] p : instance of display
+	@param[in] points : points to connect
+	@param[in] count : number of points
+*/
+void ssd1306_draw_polyline(ssd1306_t *p, const ssd1306_point_t *points, size_t count);
+
+/**
+	@brief draw circle outline on buffer
+
+	@param[in] p : instance of display
+	@param[in] x0 : x position of center
+	@param[in] y0 : y position of center
+	@param[in] r : radius
+*/
+void ssd1306_draw_circle(ssd1306_t *p, int32_t x0, int32_t y0, uint32_t r);
+
+/**
+	@brief draw circular arc on buffer
+
+	angles are in degrees, counterclockwise from the positive x axis (screen y points down)
+
+	@param[in] p : instance of display
+	@param[in] x0 : x position of center
+	@param[in] y0 : y position of center
+	@param[in] r : radius
+	@param[in] start : start angle
+	@param[in] end : end angle
+*/
+void ssd1306_draw_arc(ssd1306_t *p, int32_t x0, int32_t y0, uint32_t r, int32_t start, int32_t end);
+
 /**
 	@brief clear square at given position with given size
 
@@ -194,6 +458,47 @@ void ssd1306_clear_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width,
 */
 void ssd1306_draw_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
 
+/**
+	@brief invert square at given position with given size
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point
+	@param[in] y : y position of starting point
+	@param[in] width : width of square
+	@param[in] height : height of square
+*/
+void ssd1306_invert_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+/**
+	@brief apply a raster operation to a rectangle
+
+	the rectangle is clipped once and written a page byte at a time, partially covered
+	pages at the top and bottom are masked
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point, may be negative
+	@param[in] y : y position of starting point, may be negative
+	@param[in] width : width of rectangle
+	@param[in] height : height of rectangle
+	@param[in] rop : raster operation
+*/
+void ssd1306_fill_rect(ssd1306_t *p, int32_t x, int32_t y, int32_t width, int32_t height, ssd1306_rop_t rop);
+
+/**
+	@brief blit a column-major bitmap up to 16 pixels high
+
+	bit j of cols[i] is the pixel at (x+i, y+j), as read from two stacked pages of a canvas
+
+	@param[in] p : instance of display
+	@param[in] x : x position of starting point, may be negative
+	@param[in] y : y position of starting point, may be negative
+	@param[in] cols : one word per column
+	@param[in] width : number of columns
+	@param[in] height : number of rows used in each column (1-16)
+	@param[in] rop : raster operation applied for set bits
+*/
+void ssd1306_blit(ssd1306_t *p, int32_t x, int32_t y, const uint16_t *cols, uint32_t width, uint32_t height, ssd1306_rop_t rop);
+
 /**
 	@brief draw empty square at given position with given size
 
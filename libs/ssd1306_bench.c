@@ -0,0 +1,104 @@
+/**
+* @file ssd1306_bench.c
+*
+* host benchmark of the scale 1 glyph blitter against the per-pixel rasterizer it replaced
+*
+* both paths draw the same strings at random positions into their own canvas, the
+* buffers must stay identical and the time per string of each path is reported.
+*
+* build and run with libs/host/run_tests.sh
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ssd1306.h"
+
+// defined in font.h, which ssd1306.c includes
+extern const uint8_t font_8x5[];
+
+#define WIDTH 128
+#define HEIGHT 64
+#define CHECK_RUNS 50000
+#define TIMED_RUNS 200000
+
+// the rasterizer before the blitter: one pixel per lit bit of the glyph
+static void old_draw_char(ssd1306_t *p, uint32_t x, uint32_t y, const uint8_t *font, char c) {
+    if(c<font[3]||c>font[4])
+        return;
+
+    uint32_t parts_per_line=(font[0]>>3)+((font[0]&7)>0);
+    for(uint8_t w=0; w<font[1]; ++w) {
+        uint32_t pp=(c-font[3])*font[1]*parts_per_line+w*parts_per_line+5;
+        for(uint32_t lp=0; lp<parts_per_line; ++lp) {
+            uint8_t line=font[pp];
+
+            for(int8_t j=0; j<8; ++j, line>>=1) {
+                if(line & 1)
+                    ssd1306_draw_pixel(p, x+w, y+(lp<<3)+j);
+            }
+
+            ++pp;
+        }
+    }
+}
+
+static void old_draw_string(ssd1306_t *p, uint32_t x, uint32_t y, const char *s) {
+    for(int32_t x_n=x; *s; x_n+=font_8x5[1]+font_8x5[2])
+        old_draw_char(p, x_n, y, font_8x5, *(s++));
+}
+
+static void random_text(char *s, size_t len) {
+    for(size_t i=0; i<len; ++i)
+        s[i]=' '+rand()%95;
+    s[len]='\0';
+}
+
+static double time_strings(ssd1306_t *p, bool blit, const char *s) {
+    absolute_time_t start=get_absolute_time();
+    for(int i=0; i<TIMED_RUNS; ++i) {
+        uint32_t x=i%WIDTH, y=(i*7)%HEIGHT;
+        if(blit)
+            ssd1306_draw_string(p, x, y, 1, s);
+        else
+            old_draw_string(p, x, y, s);
+        if((i&63)==0)
+            ssd1306_clear(p);
+    }
+    return absolute_time_diff_us(start, get_absolute_time())*1000.0/TIMED_RUNS;
+}
+
+int main(void) {
+    ssd1306_t old_canvas, new_canvas;
+    char s[13];
+    srand(5);
+
+    if(!ssd1306_init_canvas(&old_canvas, WIDTH, HEIGHT) || !ssd1306_init_canvas(&new_canvas, WIDTH, HEIGHT)) {
+        printf("FAIL ssd1306_init_canvas\n");
+        return 1;
+    }
+
+    // same pixels for any text and position, including y off the page grid and wrapped x
+    for(int i=0; i<CHECK_RUNS; ++i) {
+        random_text(s, 1+rand()%12);
+        uint32_t x=rand()%(2*WIDTH), y=rand()%HEIGHT;
+
+        ssd1306_clear(&old_canvas);
+        ssd1306_clear(&new_canvas);
+        old_draw_string(&old_canvas, x, y, s);
+        ssd1306_draw_string(&new_canvas, x, y, 1, s);
+        if(memcmp(old_canvas.buffer, new_canvas.buffer, old_canvas.bufsize)!=0) {
+            printf("FAIL \"%s\" at %lu,%lu differs\n", s, (unsigned long)x, (unsigned long)y);
+            return 1;
+        }
+    }
+
+    // a 12 character SSID, the longest that fits beside the signal bars
+    random_text(s, 12);
+    double old_ns=time_strings(&old_canvas, false, s);
+    double new_ns=time_strings(&new_canvas, true, s);
+    printf("OK: %d placements identical; 12 chars: per-pixel %.0f ns, blit %.0f ns (%.1fx)\n",
+           CHECK_RUNS, old_ns, new_ns, old_ns/new_ns);
+    return 0;
+}
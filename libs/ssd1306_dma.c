@@ -0,0 +1,104 @@
+/**
+* @file ssd1306_dma.c
+*
+* non-blocking i2c transport for ssd1306 displays using a dma channel
+*/
+
+#include <pico/stdlib.h>
+#include <hardware/i2c.h>
+#include <hardware/dma.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "ssd1306_dma.h"
+
+static bool ssd1306_dma_busy(ssd1306_bus_t *bus) {
+    ssd1306_dma_t *dma=bus->ctx;
+    i2c_hw_t *hw=i2c_get_hw(dma->i2c_i);
+
+    if(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+        // the peripheral flushed its fifo, drop the rest of the frame
+        dma_channel_abort(dma->channel);
+        (void) hw->clr_tx_abrt;
+        ++(dma->aborts);
+        bus->aborted=true;
+        return false;
+    }
+
+    if(dma_channel_is_busy(dma->channel))
+        return true;
+
+    // dma is done once the last word is in the fifo, the bus is done when the stop went out
+    return !(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+static int ssd1306_dma_write(ssd1306_bus_t *bus, uint8_t addr, const uint8_t *src, size_t len) {
+    ssd1306_dma_t *dma=bus->ctx;
+
+    while(ssd1306_dma_busy(bus))
+        tight_loop_contents();
+
+    return i2c_write_blocking(dma->i2c_i, addr, src, len, false);
+}
+
+static bool ssd1306_dma_start(ssd1306_bus_t *bus, uint8_t addr, const uint8_t *src, const uint16_t *lens, size_t count) {
+    ssd1306_dma_t *dma=bus->ctx;
+    i2c_hw_t *hw=i2c_get_hw(dma->i2c_i);
+    size_t n=0;
+
+    if(ssd1306_dma_busy(bus))
+        return false;
+
+    // a stop on the last byte of each transaction, the next word starts a new one
+    for(size_t i=0; i<count; ++i) {
+        if(n+lens[i]>dma->capacity)
+            return false;
+        for(size_t j=0; j<lens[i]; ++j)
+            dma->words[n++]=*src++;
+        dma->words[n-1]|=I2C_IC_DATA_CMD_STOP_BITS;
+    }
+
+    hw->enable=0;
+    hw->tar=addr;
+    hw->dma_cr=I2C_IC_DMA_CR_TDMAE_BITS;
+    hw->enable=1;
+
+    dma_channel_config cfg=dma_channel_get_default_config(dma->channel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, i2c_get_dreq(dma->i2c_i, true));
+    dma_channel_configure(dma->channel, &cfg, &hw->data_cmd, dma->words, n, true);
+
+    return true;
+}
+
+bool ssd1306_dma_init(ssd1306_dma_t *dma, ssd1306_bus_t *bus, i2c_inst_t *i2c_instance, size_t capacity) {
+    dma->i2c_i=i2c_instance;
+    dma->aborts=0;
+    dma->capacity=capacity;
+
+    if((dma->words=malloc(capacity*sizeof(uint16_t)))==NULL)
+        return false;
+
+    if((dma->channel=dma_claim_unused_channel(false))<0) {
+        free(dma->words);
+        return false;
+    }
+
+    *bus=(ssd1306_bus_t) {
+        .write=ssd1306_dma_write,
+        .start=ssd1306_dma_start,
+        .busy=ssd1306_dma_busy,
+        .aborted=false,
+        .ctx=dma,
+    };
+
+    return true;
+}
+
+void ssd1306_dma_deinit(ssd1306_dma_t *dma) {
+    dma_channel_wait_for_finish_blocking(dma->channel);
+    dma_channel_unclaim(dma->channel);
+    free(dma->words);
+}
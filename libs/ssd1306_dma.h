@@ -0,0 +1,49 @@
+/**
+* @file ssd1306_dma.h
+*
+* non-blocking i2c transport for ssd1306 displays using a dma channel
+*/
+
+#ifndef _inc_ssd1306_dma
+#define _inc_ssd1306_dma
+#include <pico/stdlib.h>
+#include <hardware/i2c.h>
+
+#include "ssd1306.h"
+
+/**
+*	@brief state of the dma transport
+*
+*	the i2c peripheral takes 16 bit data_cmd words (data byte plus stop flag), so a staged
+*	frame is expanded into words before the dma channel is started
+*/
+typedef struct {
+    i2c_inst_t *i2c_i;	/**< i2c connection instance */
+    int channel;		/**< claimed dma channel */
+    uint16_t *words;	/**< data_cmd words of the transfer in flight */
+    size_t capacity;	/**< number of words that fit in words */
+    uint32_t aborts;	/**< transfers aborted by the i2c peripheral (e.g. nack) */
+} ssd1306_dma_t;
+
+/**
+*	@brief claim a dma channel and build the bus interface for a display
+*
+*	@param[out] dma : transport state, must outlive the display
+*	@param[out] bus : bus to pass to ssd1306_set_bus
+*	@param[in] i2c_instance : instance of i2c connection
+*	@param[in] capacity : largest transfer in bytes, including control bytes
+*
+* 	@return bool.
+*	@retval true for Success
+*	@retval false if no dma channel or memory was available
+*/
+bool ssd1306_dma_init(ssd1306_dma_t *dma, ssd1306_bus_t *bus, i2c_inst_t *i2c_instance, size_t capacity);
+
+/**
+*	@brief release the dma channel, waits for the transfer in flight
+*
+*	@param[in] dma : transport state
+*/
+void ssd1306_dma_deinit(ssd1306_dma_t *dma);
+
+#endif
@@ -0,0 +1,204 @@
+/**
+* @file ssd1306_test.c
+*
+* host test of the ssd1306 flush path against a mock bus
+*
+* the mock decodes the staged transactions into a copy of the display RAM, so after
+* every successful show the RAM must match the buffer. Failed starts, aborted transfers
+* and a bus still busy are injected to check that no frame is lost.
+*
+* build and run with libs/host/run_tests.sh
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ssd1306.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+#define PAGES (HEIGHT/8)
+
+typedef struct {
+    uint8_t ram[PAGES][WIDTH];	/**< what the panel would show */
+    uint32_t col_lo, col_hi, page_lo, page_hi;	/**< address window */
+    uint32_t col, page;	/**< next byte written */
+    bool fail_start;	/**< next start returns false */
+    bool abort_next;	/**< next started frame is cut after its first transaction */
+    bool aborted;	/**< a cut frame waits to be reported by busy */
+    int busy_polls;	/**< busy answers true this many times after a start */
+    uint32_t starts;	/**< frames handed to the mock */
+} mock_display_t;
+
+static mock_display_t mock;
+static int failures=0;
+
+#define CHECK(cond, ...) do { if(!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); ++failures; } } while(0)
+
+// applies one i2c transaction the way the controller does in horizontal addressing mode
+static void mock_apply(const uint8_t *src, size_t len) {
+    if(src[0]==0x00) {
+        if(len>=7 && src[1]==0x21 && src[4]==0x22) {
+            mock.col_lo=mock.col=src[2];
+            mock.col_hi=src[3];
+            mock.page_lo=mock.page=src[5];
+            mock.page_hi=src[6];
+        }
+        return;
+    }
+
+    for(size_t i=1; i<len; ++i) {
+        mock.ram[mock.page][mock.col]=src[i];
+        if(mock.col++==mock.col_hi) {
+            mock.col=mock.col_lo;
+            mock.page=mock.page==mock.page_hi?mock.page_lo:mock.page+1;
+        }
+    }
+}
+
+static int mock_write(ssd1306_bus_t *bus, uint8_t address, const uint8_t *src, size_t len) {
+    mock_apply(src, len);
+    return len;
+}
+
+static bool mock_start(ssd1306_bus_t *bus, uint8_t address, const uint8_t *src, const uint16_t *lens, size_t count) {
+    if(mock.busy_polls>0)
+        return false;
+    if(mock.fail_start) {
+        mock.fail_start=false;
+        return false;
+    }
+
+    ++mock.starts;
+    // a cut frame keeps its window command and loses the data
+    size_t sent=mock.abort_next?1:count;
+    for(size_t i=0; i<sent; ++i) {
+        mock_apply(src, lens[i]);
+        src+=lens[i];
+    }
+    mock.aborted=mock.abort_next;
+    mock.abort_next=false;
+    return true;
+}
+
+static bool mock_busy(ssd1306_bus_t *bus) {
+    if(mock.busy_polls>0) {
+        --mock.busy_polls;
+        return true;
+    }
+    if(mock.aborted) {
+        mock.aborted=false;
+        bus->aborted=true;
+    }
+    return false;
+}
+
+static bool ram_matches(const ssd1306_t *p) {
+    return memcmp(mock.ram, p->buffer, sizeof(mock.ram))==0;
+}
+
+static void draw_random(ssd1306_t *p) {
+    int n=1+rand()%6;
+    for(int i=0; i<n; ++i) {
+        uint32_t x=rand()%WIDTH, y=rand()%HEIGHT;
+        if(rand()%4==0)
+            ssd1306_draw_square(p, x, y, 1+rand()%20, 1+rand()%12);
+        else
+            ssd1306_draw_pixel(p, x, y);
+    }
+    if(rand()%10==0)
+        ssd1306_clear(p);
+}
+
+static void test_flush(ssd1306_t *p) {
+    ssd1306_draw_square(p, 10, 10, 30, 20);
+    CHECK(ssd1306_show_async(p), "first frame not queued");
+    CHECK(ram_matches(p), "first frame differs");
+
+    ssd1306_draw_pixel(p, 100, 50);
+    CHECK(ssd1306_show_async(p), "second frame not queued");
+    CHECK(ram_matches(p), "second frame differs");
+    CHECK(p->frame_bytes<WIDTH, "one pixel sent %lu bytes", (unsigned long)p->frame_bytes);
+}
+
+static void test_failed_start(ssd1306_t *p) {
+    ssd1306_draw_square(p, 60, 5, 8, 8);
+    mock.fail_start=true;
+    ssd1306_show_async(p);
+    CHECK(!ram_matches(p), "frame arrived although the start failed");
+
+    // nothing new drawn: the lost frame must go out anyway
+    CHECK(ssd1306_show_async(p), "frame not queued after a failed start");
+    CHECK(ram_matches(p), "frame lost after a failed start");
+}
+
+static void test_aborted(ssd1306_t *p) {
+    ssd1306_draw_square(p, 0, 40, 50, 10);
+    mock.abort_next=true;
+    ssd1306_show_async(p);
+    CHECK(!ram_matches(p), "frame arrived although it was aborted");
+
+    CHECK(!ssd1306_flush_busy(p), "aborted frame still busy");
+    CHECK(ssd1306_show_async(p), "frame not queued after an abort");
+    CHECK(ram_matches(p), "frame lost after an abort");
+}
+
+static void test_busy(ssd1306_t *p) {
+    ssd1306_draw_pixel(p, 3, 3);
+    ssd1306_show_async(p);
+    mock.busy_polls=2;
+
+    ssd1306_draw_pixel(p, 120, 60);
+    CHECK(!ssd1306_show_async(p), "frame queued while the bus was busy");
+    ssd1306_flush_wait(p);
+    CHECK(ssd1306_show_async(p), "frame not queued after the bus went idle");
+    CHECK(ram_matches(p), "changes lost while the bus was busy");
+}
+
+static void test_random(ssd1306_t *p) {
+    for(int i=0; i<20000; ++i) {
+        draw_random(p);
+        switch(rand()%8) {
+        case 0: mock.fail_start=true; break;
+        case 1: mock.abort_next=true; break;
+        case 2: mock.busy_polls=1+rand()%3; break;
+        }
+        ssd1306_show_async(p);
+    }
+
+    // a clean flush after any sequence of failures leaves the panel in sync
+    mock.fail_start=false;
+    mock.abort_next=false;
+    ssd1306_flush_wait(p);
+    ssd1306_show_async(p);
+    ssd1306_flush_wait(p);
+    CHECK(ram_matches(p), "panel out of sync after random failures");
+}
+
+int main(void) {
+    ssd1306_t disp= {.external_vcc=false};
+    srand(2);
+
+    if(!ssd1306_init(&disp, WIDTH, HEIGHT, 0x3c, NULL)) {
+        printf("FAIL ssd1306_init\n");
+        return 1;
+    }
+    ssd1306_bus_t bus= {
+        .write=mock_write,
+        .start=mock_start,
+        .busy=mock_busy,
+    };
+    ssd1306_set_bus(&disp, &bus);
+
+    test_flush(&disp);
+    test_failed_start(&disp);
+    test_aborted(&disp);
+    test_busy(&disp);
+    test_random(&disp);
+
+    printf("%s: %lu frames started, %lu bytes\n", failures?"FAILED":"OK",
+           (unsigned long)mock.starts, (unsigned long)disp.total_bytes);
+    ssd1306_deinit(&disp);
+    return failures?1:0;
+}
@@ -0,0 +1,301 @@
+/**
+ * @file wifi_connect.c
+ * @brief Implementation for the non-blocking Wi-Fi connection.
+ */
+
+#include "wifi_connect.h"
+#include "connect_cache.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/sync.h"
+#include "lwip/netif.h"
+#include <string.h>
+
+/** @brief Request written by the UI, applied when requestSeq changes; requestSeq is odd during the write (seqlock). */
+static wifi_network_t request;
+static volatile uint32_t requestSeq = 0;
+static uint32_t appliedSeq = 0;
+
+/** @brief Network being joined. */
+static wifi_network_t target;
+/** @brief Parameters of the join, from the cache or from the scan. */
+static connect_cache_entry_t joinParams;
+static volatile bool joinCached = false;
+/** @brief When the join started, and the measured times of the attempt. */
+static absolute_time_t joinStart;
+static volatile uint32_t associateMs = 0;
+static volatile uint32_t ipMs = 0;
+
+static volatile connect_state_t state = CONNECT_IDLE;
+static volatile int connectError = 0;
+/** @brief When the state last changed, in milliseconds since boot. */
+static volatile uint32_t stateSinceMs = 0;
+/** @brief Limit for the connection to get an IP address. */
+static absolute_time_t deadline;
+static char ipAddress[16];
+
+/**
+ * @brief Changes the state of the connection.
+ */
+static void setState(connect_state_t next)
+{
+    stateSinceMs = to_ms_since_boot(get_absolute_time());
+    __dmb();
+    state = next;
+}
+
+/**
+ * @brief Converts the security bits of a scan result into a cyw43 auth type.
+ *
+ * @return The auth type, or -1 for security the driver cannot join (WEP).
+ */
+static int32_t getJoinAuth(uint64_t scanAuth)
+{
+    if (scanAuth & 4) return CYW43_AUTH_WPA2_MIXED_PSK; // WPA2, com ou sem TKIP
+    if (scanAuth & 2) return CYW43_AUTH_WPA_TKIP_PSK;
+    if (scanAuth == 0) return CYW43_AUTH_OPEN;
+    return -1;
+}
+
+/**
+ * @brief Ends the attempt in progress with a failure.
+ */
+static void failConnect(int error)
+{
+    printf("Falha ao conectar em %s: %d\n", target.ssid, error);
+    cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+    connectError = error;
+    setState(CONNECT_FAILED);
+}
+
+/**
+ * @brief Milliseconds since the join started.
+ */
+static uint32_t getJoinElapsedMs()
+{
+    return absolute_time_diff_us(joinStart, get_absolute_time()) / 1000;
+}
+
+/**
+ * @brief Fills the join parameters of the target from the cache or from the scan.
+ *
+ * @return false if there is no usable passphrase for the network.
+ */
+static bool prepareJoin()
+{
+    const connect_cache_entry_t *cached = findCachedNetwork(target.bssid);
+    joinCached = cached != NULL;
+    if (cached != NULL)
+    {
+        joinParams = *cached;
+        return true;
+    }
+
+    // Rede nova: o firmware procura o SSID em todos os canais
+    int32_t auth = getJoinAuth(target.auth_mode);
+    if (auth < 0 || (auth != CYW43_AUTH_OPEN && strlen(WIFI_PASSWORD) < 8))
+    {
+        return false;
+    }
+
+    memset(&joinParams, 0, sizeof(joinParams));
+    memcpy(joinParams.bssid, target.bssid, sizeof(joinParams.bssid));
+    joinParams.channel = target.channel;
+    joinParams.auth = auth;
+    snprintf(joinParams.ssid, sizeof(joinParams.ssid), "%s", target.ssid);
+    if (auth != CYW43_AUTH_OPEN)
+    {
+        snprintf(joinParams.password, sizeof(joinParams.password), "%s", WIFI_PASSWORD);
+    }
+    return true;
+}
+
+/**
+ * @brief Starts the asynchronous join of the target network.
+ */
+static void startJoin()
+{
+    associateMs = 0;
+    ipMs = 0;
+    if (!prepareJoin())
+    {
+        failConnect(CYW43_LINK_BADAUTH); // Sem senha válida para a rede
+        return;
+    }
+
+    // Sai da rede anterior antes de associar na nova
+    if (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) != CYW43_LINK_DOWN)
+    {
+        cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+    }
+
+    // Da rede conhecida vêm o BSSID e o canal: a associação vai direto ao AP.
+    // É o que cyw43_arch_wifi_connect_bssid_async faz, mas sem fixar o canal.
+    printf("Conectando à rede: %s (%s)\n", target.ssid, joinCached ? "cache" : "varredura");
+    bool open = joinParams.auth == CYW43_AUTH_OPEN;
+    size_t keyLength = open ? 0 : strlen(joinParams.password);
+    joinStart = get_absolute_time();
+    int err = cyw43_wifi_join(&cyw43_state, strlen(joinParams.ssid), (const uint8_t *)joinParams.ssid,
+                              keyLength, (const uint8_t *)joinParams.password, joinParams.auth,
+                              joinParams.bssid, joinCached ? joinParams.channel : CYW43_CHANNEL_NONE);
+    if (err != 0)
+    {
+        failConnect(err);
+        return;
+    }
+
+    deadline = make_timeout_time_ms(WIFI_CONNECT_TIMEOUT_MS);
+    setState(CONNECT_JOINING);
+}
+
+void requestConnect(const wifi_network_t *network)
+{
+    requestSeq++; // Ímpar: pedido sendo escrito
+    __dmb();
+    request = *network;
+    __dmb();
+    requestSeq++;
+}
+
+/**
+ * @brief Takes the request made by the UI, if there is a new one.
+ */
+static bool takeRequest()
+{
+    uint32_t seq;
+
+    // Copia de novo se a UI escrevia o pedido durante a cópia
+    do
+    {
+        seq = requestSeq;
+        if (seq == appliedSeq)
+        {
+            return false;
+        }
+        __dmb();
+        target = request;
+        __dmb();
+    } while ((seq & 1) || seq != requestSeq);
+
+    appliedSeq = seq;
+    return true;
+}
+
+void updateConnect()
+{
+    if (takeRequest())
+    {
+        setState(CONNECT_PENDING);
+    }
+
+    if (state == CONNECT_PENDING)
+    {
+        // O driver não associa enquanto varre
+        if (!cyw43_wifi_scan_active(&cyw43_state))
+        {
+            startJoin();
+        }
+        return;
+    }
+
+    if (state != CONNECT_JOINING && state != CONNECT_GETTING_IP && state != CONNECT_CONNECTED)
+    {
+        return;
+    }
+
+    int status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+    if (status == CYW43_LINK_UP)
+    {
+        if (state != CONNECT_CONNECTED)
+        {
+            ipMs = getJoinElapsedMs();
+            if (associateMs == 0)
+            {
+                associateMs = ipMs; // Associação e DHCP entre duas leituras
+            }
+            cyw43_arch_lwip_begin();
+            snprintf(ipAddress, sizeof(ipAddress), "%s", ip4addr_ntoa(netif_ip4_addr(&cyw43_state.netif[CYW43_ITF_STA])));
+            cyw43_arch_lwip_end();
+            printf("Conectado a %s, IP %s (associação %lu ms, IP %lu ms, %s)\n", target.ssid, ipAddress,
+                   (unsigned long)associateMs, (unsigned long)ipMs, joinCached ? "cache" : "varredura");
+            setState(CONNECT_CONNECTED);
+
+            // Guarda os parâmetros para a próxima conexão; sem o canal não há atalho
+            if (joinParams.channel != 0)
+            {
+                rememberConnection(&joinParams);
+            }
+        }
+    }
+    else if (state == CONNECT_CONNECTED)
+    {
+        failConnect(status); // A conexão caiu
+    }
+    else if (status < 0)
+    {
+        failConnect(status); // CYW43_LINK_FAIL, CYW43_LINK_NONET ou CYW43_LINK_BADAUTH
+    }
+    else if (absolute_time_diff_us(get_absolute_time(), deadline) < 0)
+    {
+        failConnect(CYW43_LINK_FAIL); // Tempo esgotado
+    }
+    else if (status == CYW43_LINK_NOIP && state != CONNECT_GETTING_IP)
+    {
+        associateMs = getJoinElapsedMs();
+        setState(CONNECT_GETTING_IP);
+    }
+}
+
+bool isConnectBusy()
+{
+    connect_state_t current = state;
+    return requestSeq != appliedSeq || current == CONNECT_PENDING ||
+           current == CONNECT_JOINING || current == CONNECT_GETTING_IP;
+}
+
+connect_state_t getConnectState()
+{
+    return state;
+}
+
+int getConnectError()
+{
+    return connectError;
+}
+
+uint32_t getConnectStateAge()
+{
+    return to_ms_since_boot(get_absolute_time()) - stateSinceMs;
+}
+
+const char *getConnectIp()
+{
+    return ipAddress;
+}
+
+bool isConnectCached()
+{
+    return joinCached;
+}
+
+void getConnectTimes(uint32_t *associate, uint32_t *ip)
+{
+    *associate = associateMs;
+    *ip = ipMs;
+}
+
+bool requestReconnect(char *ssid)
+{
+    const connect_cache_entry_t *latest = getLatestCachedNetwork();
+    if (latest == NULL)
+    {
+        return false;
+    }
+
+    wifi_network_t network = {0};
+    memcpy(network.ssid, latest->ssid, sizeof(network.ssid));
+    memcpy(network.bssid, latest->bssid, sizeof(network.bssid));
+    network.channel = latest->channel;
+    memcpy(ssid, latest->ssid, sizeof(latest->ssid));
+    requestConnect(&network);
+    return true;
+}
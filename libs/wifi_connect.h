@@ -0,0 +1,96 @@
+/**
+ * @file wifi_connect.h
+ * @brief Header file for the non-blocking Wi-Fi connection.
+ *
+ * The UI asks for a connection with requestConnect(); the scan pipeline,
+ * which owns the cyw43 driver, starts the asynchronous join once no scan
+ * is running and follows it with cyw43_tcpip_link_status() on every step,
+ * through association, DHCP and the final result. The UI only reads the
+ * state to show the progress.
+ *
+ * Networks joined before come from the connection cache: the join targets
+ * the cached BSSID on its channel with the saved credentials, skipping the
+ * search over all channels. Every attempt measures the time to associate
+ * and the time to get an IP address.
+ */
+
+#ifndef WIFI_CONNECT_H
+#define WIFI_CONNECT_H
+
+#include "pico/stdlib.h"
+#include "patro_wifi_scanner.h"
+
+/** @brief Passphrase used for secured networks (empty: only open networks connect). */
+#ifndef WIFI_PASSWORD
+#define WIFI_PASSWORD ""
+#endif
+
+/** @brief Joins the network joined most recently as soon as the scanner starts (off by default). */
+#ifndef RECONNECT_ON_BOOT
+#define RECONNECT_ON_BOOT 0
+#endif
+
+/** @brief Time allowed from the request to an IP address. */
+#ifndef WIFI_CONNECT_TIMEOUT_MS
+#define WIFI_CONNECT_TIMEOUT_MS 20000
+#endif
+
+/** @brief Steps of a connection. */
+typedef enum {
+    CONNECT_IDLE,       // Nenhuma conexão pedida
+    CONNECT_PENDING,    // Pedida, aguardando o fim da varredura
+    CONNECT_JOINING,    // Associando e autenticando
+    CONNECT_GETTING_IP, // Associada, aguardando o DHCP
+    CONNECT_CONNECTED,  // Conectada com IP
+    CONNECT_FAILED      // Falhou; getConnectError() diz o motivo
+} connect_state_t;
+
+/**
+ * @brief Asks for a connection to a network (UI side).
+ *
+ * Replaces any connection in progress or established.
+ *
+ * @param network Network chosen in the list.
+ */
+void requestConnect(const wifi_network_t *network);
+
+/**
+ * @brief Advances the connection (scan pipeline side, on the driver's core).
+ */
+void updateConnect();
+
+/** @brief Whether a connection is pending or in progress; scans wait meanwhile. */
+bool isConnectBusy();
+
+/** @brief Returns the current step of the connection. */
+connect_state_t getConnectState();
+
+/** @brief Returns the cyw43 link status that made the connection fail. */
+int getConnectError();
+
+/** @brief Returns the time since the connection entered its current step, in milliseconds. */
+uint32_t getConnectStateAge();
+
+/** @brief Returns the IP address once connected, as text. */
+const char *getConnectIp();
+
+/** @brief Whether the attempt used the parameters of the connection cache. */
+bool isConnectCached();
+
+/**
+ * @brief Returns the times of the last attempt, from the join to each step.
+ *
+ * @param associateMs Receives the time to associate, 0 if it did not associate.
+ * @param ipMs Receives the time to get an IP address, 0 if it did not get one.
+ */
+void getConnectTimes(uint32_t *associateMs, uint32_t *ipMs);
+
+/**
+ * @brief Asks for a connection to the network joined most recently (UI side).
+ *
+ * @param ssid Receives the SSID of the network, at least 33 bytes.
+ * @return false if the connection cache is empty.
+ */
+bool requestReconnect(char *ssid);
+
+#endif // WIFI_CONNECT_H
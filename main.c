@@ -18,88 +18,156 @@
 #include "patro_wifi_scanner.h"
 #include "analog.h"
 #include "buttons.h"
-
-// Tempo de espera entre as varreduras (10 segundos)
-#define NEW_SCAN_TIMER_MS 10000 
-#define MAX_RESULTS 20
+#include "row_cache.h"
+#include "list_view.h"
+#include "frame_scheduler.h"
+#include "network_store.h"
+#include "scan_task.h"
+#include "display_list.h"
+#include "wifi_connect.h"
+#include "connect_cache.h"
+#include "input.h"
+
+#if SCAN_ON_CORE1 && RENDER_ON_CORE1
+#error "SCAN_ON_CORE1 e RENDER_ON_CORE1 usam o núcleo 1; escolha apenas um"
+#endif
 
 #define DEG2RAD 0.0174532925
 
+// Velocidade da animação do cursor (graus da senoide por segundo)
+#define CURSOR_DEG_PER_SECOND 120
+
+// Tempo que o rodapé mostra cada página (modo de autenticação, percentis do RSSI)
+#define FOOTER_PAGE_MS 3000
+
 // Pino do LED vermelho
 const uint LED_PIN_RED = 13;
 
-// Estrutura para armazenar informações de redes Wi-Fi
-typedef struct {
-    char ssid[33];      // SSID da rede Wi-Fi (32 caracteres + '\0')
-    uint8_t bssid[6];   // Endereço MAC da rede (BSSID)
-    int rssi;           // Intensidade do sinal (RSSI)
-    uint64_t auth_mode;  // Modo de autenticação (WPA, WPA2, etc.)
-    
-} wifi_network_t;
+// Lista de redes na tela (rolagem e linhas visíveis)
+list_view_t networkList;
 
-// Array para armazenar os resultados da varredura
-wifi_network_t networks[MAX_RESULTS];   
+// Alterna a rolagem por páginas (botão A)
+bool pagedList = false;
 
-int scrollY = 0; // Posição de rolagem do menu
+// Fila de botões: a interrupção só enfileira, o laço principal trata
+#define BUTTON_QUEUE_SIZE 8
+volatile uint8_t buttonQueue[BUTTON_QUEUE_SIZE];
+volatile uint32_t buttonHead = 0;
+volatile uint32_t buttonTail = 0;
 
-// Função para converter RSSI em barras de sinal (1 a 5)
-int rssiToBars(int rssi) {
-    if (rssi >= -50) return 5; // Excelente sinal
-    if (rssi >= -60) return 4; // Bom sinal
-    if (rssi >= -70) return 3; // Sinal razoável
-    if (rssi >= -80) return 2; // Sinal fraco
-    return 1; // Sem sinal
-}
+// Rede da última conexão pedida (botão B)
+char connectSsid[33] = "";
 
-// Função chamada automaticamente sempre que um resultado de varredura
-// é encontrado. O resultado é passado como argumento (result).
-static int scanResult(void *env, const cyw43_ev_scan_result_t *result)
-{
-    // Pular redes com SSID vazio ou nulo
-    if (!result || strlen((const char*)result->ssid) == 0)
-        return 0; 
+// Tempo que o resultado da conexão fica no rodapé (IP e tempos alternam por página)
+#define CONNECT_RESULT_MS 8000
 
-    // Verifica se o BSSID já está na lista
-    for (int i = 0; i < network_count; i++)
-    {
-        // Compara o BSSID da rede atual com os já encontrados
-        if (memcmp(networks[i].bssid, result->bssid, sizeof(networks[i].bssid)) == 0)
-        {
-            // Atualiza o RSSI se já estiver na lista
-            networks[i].rssi = result->rssi; 
-            return 0;
-        }
-    }
+// Tela atual, trocada com o joystick na horizontal
+display_screen_t currentScreen = SCREEN_NETWORKS;
 
-    if (network_count < MAX_RESULTS)
-    {
-        // Copia o SSID da rede encontrada para a estrutura
-        strncpy(networks[network_count].ssid, (const char*)result->ssid, 32);
-        networks[network_count].ssid[32] = '\0'; // Garante que a string esteja terminada
+// Rede acompanhada na tela de rastreamento
+wifi_network_t trackedNetwork;
+
+// Atualizações por segundo da rede rastreada, em décimos
+uint32_t trackRateTenths = 0;
+
+// Incrementado sempre que uma nova lista de redes é publicada
+volatile uint32_t networksVersion = 0;
+
+// Ritmo dos quadros e estatísticas de desempenho
+frame_scheduler_t frameScheduler;
 
-        // Copia o BSSID da rede encontrada para a estrutura
-        memcpy(networks[network_count].bssid, result->bssid, sizeof(networks[network_count].bssid)); 
+// BSSID da rede selecionada, para manter a seleção quando a ordem muda
+uint8_t selectedBssid[6] = {0};
 
-        // Armazena a intensidade do sinal (RSSI) da rede encontrada
-        networks[network_count].rssi = result->rssi; 
+// Quadro desenhado que ainda não pôde ser enviado ao display
+bool displayPending = false;
 
-        // Armazena o modo de autenticação da rede encontrada
-        networks[network_count].auth_mode = result->auth_mode;
+// Janelas de estatísticas entre cada relatório no console
+#define TELEMETRY_EVERY_WINDOWS 5
 
-        network_count++; // Incrementa o contador de redes encontradas
+/**
+ * @brief Página atual do rodapé, alternada a cada FOOTER_PAGE_MS.
+ */
+int getFooterPage()
+{
+    return to_ms_since_boot(get_absolute_time()) / FOOTER_PAGE_MS % 2;
+}
+
+/**
+ * @brief Escreve o andamento da conexão no rodapé.
+ *
+ * @return false se não há conexão para mostrar.
+ */
+bool formatConnectStatus(char *details, size_t size)
+{
+    connect_state_t state = getConnectState();
+    uint32_t seconds = getConnectStateAge() / 1000;
+
+    switch (state) {
+    case CONNECT_PENDING:
+        snprintf(details, size, "Waiting scan...");
+        return true;
+    case CONNECT_JOINING:
+        // Rede conhecida: associa direto no BSSID e canal guardados
+        snprintf(details, size, "%s %.11s %lus", isConnectCached() ? "Rejoin" : "Joining",
+                 connectSsid, (unsigned long)seconds);
+        return true;
+    case CONNECT_GETTING_IP:
+        snprintf(details, size, "Getting IP %lus", (unsigned long)seconds);
+        return true;
+    case CONNECT_CONNECTED:
+    case CONNECT_FAILED:
+        if (getConnectStateAge() >= CONNECT_RESULT_MS) {
+            return false; // Volta aos detalhes da rede
+        }
+        if (state == CONNECT_CONNECTED && getFooterPage() == 1) {
+            // Tempos da tentativa: associação e IP, contados do início da associação
+            uint32_t associateMs, ipMs;
+            getConnectTimes(&associateMs, &ipMs);
+            snprintf(details, size, "Assoc %lu.%lus IP %lu.%lus",
+                     (unsigned long)(associateMs / 1000), (unsigned long)(associateMs % 1000 / 100),
+                     (unsigned long)(ipMs / 1000), (unsigned long)(ipMs % 1000 / 100));
+        } else if (state == CONNECT_CONNECTED) {
+            snprintf(details, size, "IP %s", getConnectIp());
+        } else {
+            int error = getConnectError();
+            if (error == CYW43_LINK_BADAUTH) {
+                snprintf(details, size, "Failed: auth");
+            } else if (error == CYW43_LINK_NONET) {
+                snprintf(details, size, "Failed: no network");
+            } else {
+                snprintf(details, size, "Failed: error %d", error);
+            }
+        }
+        return true;
+    default:
+        return false;
     }
-    return 0; // Retorna 0 para continuar a varredura.
 }
 
-void drawNetworkDetailsAtBottom(int selectedOption) {
-    int y = SCREEN_HEIGHT - TEXT_HEIGHT - 1; // Posição do texto na parte inferior
-    char details[64];
+/**
+ * @brief Escreve os detalhes da rede selecionada, exibidos no rodapé.
+ *        O rodapé alterna entre o modo de autenticação e os percentis do RSSI.
+ */
+void formatNetworkDetails(char *details, size_t size, int selectedOption) {
+    if (formatConnectStatus(details, size)) {
+        return;
+    }
 
-    drawClearRectangle(0, y, SCREEN_WIDTH, SCREEN_HEIGHT); // Limpa a área do texto
-    drawLine(0, y, SCREEN_WIDTH, y); // Linha horizontal
+    if (network_count == 0) {
+        details[0] = '\0'; // Sem rede selecionada (selectedOption é -1)
+        return;
+    }
 
-    uint64_t thisAuthMode = networks[selectedOption].auth_mode; // Modo de autenticação da rede selecionada
-    snprintf(details, sizeof(details), "Mode: %s",
+    wifi_network_t *network = getRankedNetwork(selectedOption);
+    if (getFooterPage() == 1) {
+        snprintf(details, size, "P10/50/90 %d/%d/%d", network->percentiles[0],
+                 network->percentiles[1], network->percentiles[2]);
+        return;
+    }
+
+    uint64_t thisAuthMode = network->auth_mode; // Modo de autenticação da rede selecionada
+    snprintf(details, size, "Mode: %s",
                 thisAuthMode == CYW43_AUTH_OPEN ? "Open" :
                 thisAuthMode == CYW43_AUTH_WPA2_AES_PSK ? "WPA2 (AES)" :
                 thisAuthMode == CYW43_AUTH_WPA2_MIXED_PSK ? "WPA2 (Misto)" :
@@ -109,101 +177,347 @@ void drawNetworkDetailsAtBottom(int selectedOption) {
                 "Locked");
 
     if (thisAuthMode == CYW43_AUTH_WPA2_AES_PSK) {
-        printf("Rede: %s\n", networks[selectedOption].ssid); // Exibe o SSID da rede selecionada
+        printf("Rede: %s\n", network->ssid); // Exibe o SSID da rede selecionada
         printf("Modo de autenticação: WPA2 (AES)\n"); // Exibe o modo de autenticação no console
     }
 
     if (thisAuthMode == CYW43_AUTH_WPA2_MIXED_PSK) {
-        printf("Rede: %s\n", networks[selectedOption].ssid); // Exibe o SSID da rede selecionada
+        printf("Rede: %s\n", network->ssid); // Exibe o SSID da rede selecionada
         printf("Modo de autenticação: WPA2 (Misto)\n"); // Exibe o modo de autenticação no console
     }
 
     if (thisAuthMode == CYW43_AUTH_OPEN) {
-        printf("Rede: %s\n", networks[selectedOption].ssid); // Exibe o SSID da rede selecionada
+        printf("Rede: %s\n", network->ssid); // Exibe o SSID da rede selecionada
         printf("Modo de autenticação: Aberta\n"); // Exibe o modo de autenticação no console
     }
+}
 
-    drawText(0, y + 1, details); // Exibe o modo de autenticação da rede selecionada
+/**
+ * @brief Posição X do cursor animado, derivada do tempo e não do número de quadros.
+ */
+int getCursorX()
+{
+    uint32_t _timer = (uint64_t)to_ms_since_boot(get_absolute_time()) * CURSOR_DEG_PER_SECOND / 1000 % 360;
+    return 2 + sin(_timer * DEG2RAD) * 2; // Animação de destaque
 }
 
 /**
- * @brief Função para exibir as redes Wi-Fi encontradas no display.
- *        Limpa o display antes de exibir os resultados.
+ * @brief Troca a lista exibida pelo último snapshot publicado pela varredura.
  */
-void showNetworksOnDisplay() 
+void updateShownNetworks()
+{
+    if (acquireNetworks()) {
+        networksVersion++; // Redesenha com os dados novos
+    }
+}
+
+/**
+ * @brief Guarda o BSSID da rede na posição selecionada.
+ */
+void rememberSelection()
+{
+    if (selectedOption < 0) selectedOption = 0;
+    if (selectedOption >= network_count) selectedOption = network_count - 1;
+    if (network_count > 0) {
+        memcpy(selectedBssid, getRankedNetwork(selectedOption)->bssid, sizeof(selectedBssid));
+    }
+}
+
+/**
+ * @brief Acompanha a rede selecionada quando a varredura muda a ordem da lista.
+ *        Se a rede saiu da lista, a seleção fica na mesma posição.
+ */
+void followSelection()
 {
-    static int _timer = 0;
-    _timer += 4;
-    if (_timer > 360) {
-        _timer -= 360;
+    int rank = findNetwork(selectedBssid);
+    if (rank >= 0) {
+        selectedOption = rank;
+    } else {
+        rememberSelection();
     }
+}
 
-    clearDisplay(); 
+/**
+ * @brief Verifica se algo visível mudou desde o último quadro desenhado.
+ */
+bool needsRedraw()
+{
+    static int lastSelected = -1;
+    static int lastCount = -1;
+    static uint32_t lastVersion = 0;
+    static int lastCursorX = -1;
+    static bool lastPaged = false;
+    static int lastFooterPage = -1;
+    static display_screen_t lastScreen = SCREEN_COUNT;
+    static uint32_t lastTrackSamples = 0;
+    static uint32_t lastTrackRate = 0;
+    static uint32_t lastProfileState = 0;
+    static uint32_t lastConnectState = 0;
+
+    // Cursor e rodapé animados só existem na tela de redes
+    bool onList = currentScreen == SCREEN_NETWORKS;
+    int cursorX = onList ? getCursorX() : -1;
+    int footerPage = onList ? getFooterPage() : -1;
+    uint32_t trackSamples = currentScreen == SCREEN_TRACKING ? getTrackedSampleCount() : 0;
+    uint32_t profileState = currentScreen == SCREEN_SPECTRUM ?
+                            getScanProfile() + getScanProfileStats(getScanProfile())->sweeps * SCAN_PROFILE_COUNT : 0;
+    // Estado da conexão e segundos no estado: o rodapé mostra o andamento
+    uint32_t connectState = onList ? getConnectState() + getConnectStateAge() / 1000 * 8 : 0;
+    bool changed = selectedOption != lastSelected || network_count != lastCount ||
+                   networksVersion != lastVersion || cursorX != lastCursorX ||
+                   pagedList != lastPaged || footerPage != lastFooterPage ||
+                   currentScreen != lastScreen || trackSamples != lastTrackSamples ||
+                   trackRateTenths != lastTrackRate || profileState != lastProfileState ||
+                   connectState != lastConnectState ||
+                   (onList && isListViewScrolling(&networkList)) || displayPending;
+
+    lastSelected = selectedOption;
+    lastCount = network_count;
+    lastVersion = networksVersion;
+    lastCursorX = cursorX;
+    lastPaged = pagedList;
+    lastFooterPage = footerPage;
+    lastScreen = currentScreen;
+    lastTrackSamples = trackSamples;
+    lastTrackRate = trackRateTenths;
+    lastProfileState = profileState;
+    lastConnectState = connectState;
+    return changed;
+}
 
-    int targetScrollY = MIN(selectedOption, network_count - 3)* 10; // Posição alvo para rolagem
+/**
+ * @brief Monta a lista de exibição da tela de redes e a envia ao renderizador.
+ */
+void showNetworksOnDisplay() 
+{
+    display_list_t *list = beginDisplayList();
+    list->removed = *getRemovedNetworks();
 
-    scrollY = approach(scrollY, targetScrollY, 1); // Atualiza a posição de rolagem
+    setListViewItems(&networkList, network_count, selectedOption);
+    networkList.paged = pagedList;
+    updateListView(&networkList); // Atualiza a posição de rolagem
 
-    int y = 22 - scrollY;
-    for (int i = 0; i < network_count; i++)
+    // Apenas as linhas que aparecem entre o cabeçalho e o rodapé
+    int first, last;
+    getListViewVisibleRange(&networkList, &first, &last);
+    for (int i = first; i <= last; i++)
     {
-        // Formata o SSID e RSSI para exibição
-        char ssid[33];
-        char rssi[16];
-        snprintf(ssid, sizeof(ssid), "%s", networks[i].ssid);
-        snprintf(rssi, sizeof(rssi), "(%ddBm)", networks[i].rssi);
+        int y = getListViewRowY(&networkList, i);
+        addDisplayRow(list, getRankedNetwork(i), y, i == selectedOption);
 
-        // Desenha o nome da rede (SSID)
         if (i == selectedOption) {
-            int _x = 2 + sin(_timer * DEG2RAD) * 2; // Animação de destaque
-            drawText(_x, y, ">"); 
-            drawText(8, y, ssid); 
-        } else {
-            drawText(0, y, ssid); 
-        }        
-
-        // Desenhar o Sinal (RSSI)
-        int _rssi_x = SCREEN_WIDTH - 20; // Posição do RSSI
-        drawClearRectangle(_rssi_x - 2, y, 50, TEXT_HEIGHT); // Limpa a área do RSSI
-        
-        int bars = rssiToBars(networks[i].rssi);
-        drawSignalBars(_rssi_x, y, bars);
-
-        y += 10;
-        if (y >= SCREEN_HEIGHT) break;
+            list->cursorVisible = true;
+            list->cursorX = getCursorX();
+            list->cursorY = y;
+        }
+    }
+
+    if (networkList.paged && network_count > 0) {
+        snprintf(list->subtitle, sizeof(list->subtitle), "Page %d/%d (%d)",
+                 getListViewPage(&networkList) + 1, getListViewPageCount(&networkList), network_count);
+    } else {
+        snprintf(list->subtitle, sizeof(list->subtitle), "Networks found (%d)", network_count);
+    }
+    formatNetworkDetails(list->footer, sizeof(list->footer), selectedOption); // Detalhes da rede selecionada
+
+    // Se o quadro anterior ainda está sendo enviado, tenta de novo no próximo tick
+    displayPending = !submitDisplayList();
+}
+
+/**
+ * @brief Monta a tela do espectro de 2,4 GHz a partir dos agregados por canal.
+ *
+ * A potência de cada canal soma a dos vizinhos ponderada pela sobreposição
+ * de canais de 20 MHz espaçados de 5 MHz: 1, 3/4, 1/2 e 1/4 até 3 canais de distância.
+ */
+void showSpectrumOnDisplay()
+{
+    display_list_t *list = beginDisplayList();
+    list->screen = SCREEN_SPECTRUM;
+    list->removed = *getRemovedNetworks();
+
+    int best = 1;
+    float bestPower = -1;
+
+    for (int c = 1; c <= SPECTRUM_CHANNELS; c++)
+    {
+        const channel_stats_t *stats = getChannelStats(c);
+        spectrum_bar_t *bar = &list->spectrum[c - 1];
+        bar->strongest = stats->strongest;
+        bar->count = stats->count > 255 ? 255 : stats->count;
+
+        float power = 0;
+        for (int d = -3; d <= 3; d++)
+        {
+            int neighbor = c + d;
+            if (neighbor >= 1 && neighbor <= CHANNEL_COUNT)
+            {
+                power += getChannelStats(neighbor)->powerMw * (4 - abs(d)) / 4;
+            }
+        }
+        bar->spread = power > 0 ? (int8_t)(10 * log10f(power)) : INT8_MIN;
+
+        // Melhor canal entre os que não se sobrepõem (1, 6 e 11)
+        if ((c == 1 || c == 6 || c == 11) && (bestPower < 0 || power < bestPower)) {
+            best = c;
+            bestPower = power;
+        }
     }
 
-    drawAppHeader(); // Desenha o cabeçalho
-    drawNetworkDetailsAtBottom(selectedOption); // Exibe detalhes da rede selecionada
+    // Perfil de varredura e a medição da sua última varredura
+    scan_profile_t profile = getScanProfile();
+    const scan_profile_stats_t *sweep = getScanProfileStats(profile);
+    if (sweep->sweeps > 0) {
+        snprintf(list->subtitle, sizeof(list->subtitle), "%s %lu.%lus %u APs", getScanProfileConfig(profile)->name,
+                 (unsigned long)(sweep->lastDurationMs / 1000), (unsigned long)(sweep->lastDurationMs % 1000 / 100),
+                 sweep->lastFound);
+    } else {
+        snprintf(list->subtitle, sizeof(list->subtitle), "%s scan...", getScanProfileConfig(profile)->name);
+    }
+    snprintf(list->footer, sizeof(list->footer), "Best channel: %d", best);
 
-    showDisplay();
+    // Se o quadro anterior ainda está sendo enviado, tenta de novo no próximo tick
+    displayPending = !submitDisplayList();
 }
 
-int compareByRSSI(const void *a, const void *b) {
-    const wifi_network_t *networkA = (const wifi_network_t *)a;
-    const wifi_network_t *networkB = (const wifi_network_t *)b;
-    return networkB->rssi - networkA->rssi; // Ordena em ordem decrescente de RSSI
+/**
+ * @brief Mede as atualizações por segundo da rede rastreada, em janelas de um segundo.
+ */
+void updateTrackingRate()
+{
+    static absolute_time_t windowStart;
+    static uint32_t windowSamples = 0;
+
+    int64_t elapsedUs = absolute_time_diff_us(windowStart, get_absolute_time());
+    if (elapsedUs < 1000000) {
+        return;
+    }
+
+    uint32_t samples = getTrackedSampleCount();
+    uint32_t fresh = samples >= windowSamples ? samples - windowSamples : samples; // Zera ao trocar de rede
+    trackRateTenths = (uint64_t)fresh * 10000000 / elapsedUs;
+    windowSamples = samples;
+    windowStart = get_absolute_time();
 }
 
+/**
+ * @brief Troca de tela; a tela de rastreamento acompanha a rede selecionada.
+ *
+ * @param screen Nova tela.
+ */
+void switchScreen(display_screen_t screen)
+{
+    if (screen == SCREEN_TRACKING) {
+        if (network_count == 0) {
+            screen = currentScreen == SCREEN_NETWORKS ? SCREEN_SPECTRUM : SCREEN_NETWORKS; // Nada para rastrear
+        } else {
+            trackedNetwork = *getRankedNetwork(selectedOption);
+            trackRateTenths = 0;
+            requestTracking(&trackedNetwork);
+        }
+    }
+    if (currentScreen == SCREEN_TRACKING && screen != SCREEN_TRACKING) {
+        requestTracking(NULL); // Volta às varreduras completas
+    }
+    currentScreen = screen;
+}
+
+/**
+ * @brief Monta a tela de rastreamento: gráfico do RSSI da rede selecionada e taxa de atualização.
+ */
+void showTrackingOnDisplay()
+{
+    display_list_t *list = beginDisplayList();
+    list->screen = SCREEN_TRACKING;
+    list->removed = *getRemovedNetworks();
+    list->graphCount = getTrackedSamples(list->graph, TRACK_GRAPH_POINTS);
+
+    snprintf(list->subtitle, sizeof(list->subtitle), "%s", trackedNetwork.ssid);
+    if (list->graphCount > 0) {
+        snprintf(list->footer, sizeof(list->footer), "%d dBm  %lu.%lu upd/s",
+                 list->graph[list->graphCount - 1],
+                 (unsigned long)(trackRateTenths / 10), (unsigned long)(trackRateTenths % 10));
+    } else {
+        snprintf(list->footer, sizeof(list->footer), "Tracking...");
+    }
+
+    // Se o quadro anterior ainda está sendo enviado, tenta de novo no próximo tick
+    displayPending = !submitDisplayList();
+}
+
+/**
+ * @brief Exibe as estatísticas de desempenho no console.
+ */
+void printTelemetry()
+{
+    uint32_t rowLookups = rowCacheHits + rowCacheMisses;
+    printf("[frame] %lu us (media %lu us) | %lu fps | ocioso %lu%% | %lu bytes/quadro | cache %lu%%\n",
+           (unsigned long)frameScheduler.frameTimeUs, (unsigned long)frameScheduler.avgFrameTimeUs,
+           (unsigned long)frameScheduler.fps, (unsigned long)frameScheduler.idlePercent,
+           (unsigned long)display.frame_bytes,
+           (unsigned long)(rowLookups ? rowCacheHits * 100 / rowLookups : 0));
+    printf("[scan] perfil %s | intervalo %lu ms | mudanças %lu\n",
+           getScanProfileConfig(getScanProfile())->name, (unsigned long)getScanInterval(),
+           (unsigned long)getScanChurnScore());
+#if RENDER_ON_CORE1
+    printf("[cores] núcleo 0 %lu%% (lista) | núcleo 1 %lu%% (desenho) | %lu quadros desenhados\n",
+           (unsigned long)(100 - frameScheduler.idlePercent), (unsigned long)renderBusyPercent,
+           (unsigned long)renderedFrames);
+#endif
+}
 
 void confirmButtonCallback(uint gpio, uint32_t events) {
-    if (gpio == BTA) {
-        
-    } else if (gpio == BTB) {
-        // Selecionar rede
-        if (network_count > 0 && selectedOption < network_count) {
-            // Conectar à rede selecionada
-            printf("Conectando à rede: %s\n", networks[selectedOption].ssid);
-            printf("Ainda não implementado.\n");
-            int err = cyw43_arch_wifi_connect_timeout_ms(networks[selectedOption].ssid, NULL, networks[selectedOption].auth_mode, 10000);
-            if (err == 0) {
-                printf("Conectado com sucesso!\n");
-                // Aqui você pode adicionar código para lidar com a conexão bem-sucedida
-            } else {
-                printf("Falha ao conectar: %d\n", err);
-                // Aqui você pode adicionar código para lidar com a falha de conexão
-            }
-        } 
+    // Contexto de interrupção: apenas enfileira o botão (descarta se a fila estiver cheia)
+    uint32_t head = buttonHead;
+    if (head - buttonTail < BUTTON_QUEUE_SIZE) {
+        buttonQueue[head % BUTTON_QUEUE_SIZE] = gpio;
+        buttonHead = head + 1;
+    }
+}
+
+/**
+ * @brief Trata um evento do joystick.
+ *
+ * Na vertical move a seleção (o passo cresce enquanto a direção é mantida)
+ * ou, no espectro, troca o perfil de varredura; na horizontal troca de tela.
+ */
+void handleInputEvent(const input_event_t *event)
+{
+    bool vertical = event->direction == INPUT_UP || event->direction == INPUT_DOWN;
+    int sign = event->direction == INPUT_UP || event->direction == INPUT_LEFT ? -1 : 1;
+
+    if (!vertical) {
+        if (!event->repeat) {
+            switchScreen((currentScreen + (sign > 0 ? 1 : SCREEN_COUNT - 1)) % SCREEN_COUNT);
+        }
+    } else if (currentScreen == SCREEN_SPECTRUM) {
+        if (!event->repeat) {
+            setScanProfile((getScanProfile() + (sign > 0 ? 1 : SCAN_PROFILE_COUNT - 1)) % SCAN_PROFILE_COUNT);
+        }
+    } else {
+        selectedOption += sign * event->step;
+        rememberSelection(); // A seleção passa a seguir esta rede
+    }
+}
+
+/**
+ * @brief Trata os botões enfileirados pela interrupção.
+ */
+void handleButtonEvents()
+{
+    while (buttonTail != buttonHead) {
+        uint gpio = buttonQueue[buttonTail % BUTTON_QUEUE_SIZE];
+        buttonTail++;
+
+        if (gpio == BTA) {
+            // Alterna entre rolagem contínua e paginação
+            pagedList = !pagedList;
+        } else if (gpio == BTB && currentScreen == SCREEN_NETWORKS && network_count > 0) {
+            // Conectar à rede selecionada; a varredura conduz a conexão sem bloquear
+            wifi_network_t *network = getRankedNetwork(selectedOption);
+            snprintf(connectSsid, sizeof(connectSsid), "%s", network->ssid);
+            requestConnect(network);
+        }
     }
 }
 
@@ -214,19 +528,25 @@ int main()
     sleep_ms(369);
     printf("* Patro Wi-fi Scanner - Embarcatech 2025\n");
     
-    initAnalog(); // Inicializa os pinos analógicos
+    initAnalog(); // Inicializa os pinos analógicos e a amostragem do ADC por DMA
+    startInput(); // Lê o joystick em um timer, independente dos quadros
     initializeButtons(); // Inicializa os botões
     setButtonCallback(confirmButtonCallback); // Configura o callback para os botões
 
     // Inicializar LED
     initI2C();
     initDisplay(); // Inicializa o display I2C
+    initRowCache(); // Prepara o cache das linhas da lista
+    clearNetworks(); // Inicializa a tabela de redes e o índice por BSSID
+    initListView(&networkList, 22, 17, SCREEN_HEIGHT - TEXT_HEIGHT - 1, 10, TEXT_HEIGHT); // Área entre o cabeçalho e o rodapé
     clearDisplay();
     drawTextCentered("Patro Wi-fi Scanner", SCREEN_HEIGHT / 2 - 8);
     showDisplay(); // Limpa o display
+    loadConnectCache(); // Antes do núcleo 1: a leitura da flash não concorre com gravações
+    startRenderer(); // Com RENDER_ON_CORE1, o núcleo 1 passa a desenhar e enviar os quadros
 
-    // Inicializar wi-fi  
-    if (cyw43_arch_init())
+    // Inicializar wi-fi (no núcleo 1 com SCAN_ON_CORE1) em modo Station
+    if (!startScanTask())
     {
         printf("Falha ao inicializar o Wi-Fi\n");
         return 1;
@@ -234,84 +554,55 @@ int main()
 
     printf("Wi-Fi inicializado com sucesso\n");
 
-    // Ativa o modo Station (STA)
-    cyw43_arch_enable_sta_mode();
-
-    // Inicia varredura imeditamente.
-    absolute_time_t scanTime = make_timeout_time_ms(0);
+#if RECONNECT_ON_BOOT
+    // Volta para a última rede conectada sem esperar a varredura encontrá-la
+    if (requestReconnect(connectSsid)) {
+        printf("Reconectando à rede: %s\n", connectSsid);
+    }
+#endif
 
-    bool scanning = false;
+    initFrameScheduler(&frameScheduler, TARGET_FPS);
+    uint32_t telemetryWindows = 0;
 
     while (true)
     {
 
-        // Obter input
-        updateAxis();
-        if (inputCooldown < 0) {
-            if (analog_y < 0)
-            {
-                selectedOption--;
-                inputCooldown = 10; 
-            }
-            else if (analog_y > 0)
-            {
-                selectedOption++;
-                inputCooldown = 10;
-            }
-            if (selectedOption < 0) selectedOption = 0;
-            if (selectedOption >= network_count) selectedOption = network_count - 1;
-        } else {
-            inputCooldown--;
+        // Eventos do joystick, gerados pelo timer de entrada com o próprio relógio
+        input_event_t event;
+        while (getInputEvent(&event)) {
+            handleInputEvent(&event);
         }
+        handleButtonEvents();
 
-        if (absolute_time_diff_us(get_absolute_time(), scanTime) < 0)
-        {
-            // Se nenhuma varredura estiver em andamento, inicia uma nova varredura.
-            if (!scanning)
-            {
-                // Cria uma estrutura para configurar as opções de varredura.
-                cyw43_wifi_scan_options_t scanOptions = {0};
-
-                // Inicia a varredura wi-fi utilizando as opções configuradas.
-                int err = cyw43_wifi_scan(&cyw43_state, &scanOptions, NULL, scanResult);
-                
-                if (err == 0)
-                {
-                    printf("Iniciando varredura...\n");
-                    network_count = 0; // Limpa os dados antigos
-                    scanning = true;
-                }
-                else
-                {
-                    printf("Erro ao iniciar varredura: %d\n", err);
-                    scanTime = make_timeout_time_ms(NEW_SCAN_TIMER_MS);
-                }
-            }
-            else if (!cyw43_wifi_scan_active(&cyw43_state))
-            {
-                printf("Varredura concluída\n");
-                
-                // Reiniciar
-                selectedOption = 0; // Reinicia a seleção
-                scrollY = 0; // Reinicia a rolagem
+#if !SCAN_ON_CORE1
+        // Varredura no mesmo núcleo da interface
+        updateScanTask();
+#endif
+        updateShownNetworks();
+        updateTrackingRate();
 
-                // Ordena as redes encontradas por RSSI (intensidade do sinal)
-                qsort(networks, network_count, sizeof(wifi_network_t), compareByRSSI);
+        // A lista já chega ordenada por RSSI; a seleção acompanha a rede escolhida
+        followSelection();
 
-                scanTime = make_timeout_time_ms(NEW_SCAN_TIMER_MS);
-                scanning = false;
+        // Redesenha apenas quando algo mudou ou há uma animação em andamento
+        if (needsRedraw())
+        {
+            beginFrame(&frameScheduler);
+            if (currentScreen == SCREEN_SPECTRUM) {
+                showSpectrumOnDisplay();
+            } else if (currentScreen == SCREEN_TRACKING) {
+                showTrackingOnDisplay();
+            } else {
+                showNetworksOnDisplay();
             }
+            endFrame(&frameScheduler);
         }
 
-        showNetworksOnDisplay();
-
-#if PICO_CYW43_ARCH_POLL
-            cyw43_arch_poll();
-            cyw43_arch_wait_for_work_until(scanTime);
-#else
-            
-        // sleep_ms(NEW_SCAN_TIMER_MS);
-#endif
+        // Dorme até o próximo tick (no modo poll, atende o driver Wi-Fi enquanto espera)
+        if (waitForNextTick(&frameScheduler) && ++telemetryWindows % TELEMETRY_EVERY_WINDOWS == 0)
+        {
+            printTelemetry();
+        }
     }
         // Libera os recursos do wi-fi antes de encerrar o programa.
         cyw43_arch_deinit();